@@ -0,0 +1,116 @@
+#ifndef BENCHMARKHELPER_HPP_
+#define BENCHMARKHELPER_HPP_
+
+// to resolve https://github.com/open-mpi/ompi/issues/5157
+#define OMPI_SKIP_MPICXX 1
+#include <mpi.h>
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "mpi/MPISystem.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+namespace benchmarks {
+
+/**
+ * the communicator of the first numRanks ranks of MPI_COMM_WORLD, MPI_COMM_NULL on the others;
+ * the communicators are created once and never freed, cf. getCartesianComm
+ */
+inline CommunicatorType getFirstRanksComm(int numRanks) {
+  static std::map<int, CommunicatorType> comms;
+  auto found = comms.find(numRanks);
+  if (found != comms.end()) {
+    return found->second;
+  }
+  int worldRank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+  MPI_Comm comm;
+  MPI_Comm_split(MPI_COMM_WORLD, worldRank < numRanks ? 0 : MPI_UNDEFINED, worldRank, &comm);
+  comms[numRanks] = comm;
+  return comm;
+}
+
+/**
+ * a cartesian communicator on comm with a balanced process grid of the given dimensionality;
+ * as the DistributedFullGrid caches the cartesian communicator's layout by its handle, the
+ * communicators are created once and never freed (a freed handle may be reused by MPI)
+ */
+inline CommunicatorType getCartesianComm(CommunicatorType comm, DimType dim,
+                                         std::vector<int>& procs) {
+  static std::map<std::pair<CommunicatorType, DimType>,
+                  std::pair<CommunicatorType, std::vector<int>>>
+      cartesianComms;
+  auto found = cartesianComms.find({comm, dim});
+  if (found == cartesianComms.end()) {
+    std::vector<int> newProcs(dim, 0);
+    MPI_Dims_create(getCommSize(comm), static_cast<int>(dim), newProcs.data());
+    std::vector<int> periods(dim, 0);
+    MPI_Comm cartesianComm;
+    MPI_Cart_create(comm, static_cast<int>(dim), newProcs.data(), periods.data(), false,
+                    &cartesianComm);
+    found = cartesianComms.emplace(std::make_pair(comm, dim),
+                                   std::make_pair(cartesianComm, newProcs))
+                .first;
+  }
+  procs = found->second.second;
+  return found->second.first;
+}
+
+/**
+ * checks that the benchmark can run with numRanks ranks; if not, all ranks skip it consistently
+ */
+inline bool requireRanks(benchmark::State& state, int numRanks) {
+  int worldSize;
+  MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+  if (numRanks > worldSize) {
+    state.SkipWithError("not enough MPI ranks");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * runs the benchmark loop for a function that is (potentially) collective in comm;
+ * all ranks of MPI_COMM_WORLD have to call this, the ones with comm == MPI_COMM_NULL only take
+ * part in the timing. The iteration time is the maximum over all ranks, so every rank takes the
+ * same decisions on the number of iterations (register the benchmark with UseManualTime()).
+ */
+template <typename Function>
+void runCollectively(benchmark::State& state, CommunicatorType comm, Function&& function) {
+  for (auto _ : state) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    const auto start = std::chrono::steady_clock::now();
+    if (comm != MPI_COMM_NULL) {
+      function();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double myTime = elapsed.count();
+    double maxTime = 0.;
+    MPI_Allreduce(&myTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    state.SetIterationTime(maxTime);
+  }
+}
+
+/** random coordinates in [0,1]^dim, the same on all ranks */
+inline std::vector<std::vector<real>> getRandomCoordinates(size_t numCoordinates, DimType dim) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<real> distribution(0., 1.);
+  std::vector<std::vector<real>> coordinates(numCoordinates, std::vector<real>(dim));
+  for (auto& coordinate : coordinates) {
+    for (auto& c : coordinate) {
+      c = distribution(generator);
+    }
+  }
+  return coordinates;
+}
+
+}  // namespace benchmarks
+}  // namespace combigrid
+
+#endif /* BENCHMARKHELPER_HPP_ */
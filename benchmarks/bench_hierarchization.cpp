@@ -0,0 +1,126 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "hierarchization/CombiLinearBasisFunction.hpp"
+#include "hierarchization/DistributedHierarchization.hpp"
+
+using namespace combigrid;
+using namespace combigrid::benchmarks;
+
+namespace {
+
+typedef void (*KernelType)(real*, LevelType, LevelType);
+
+/**
+ * one 1D (de)hierarchization kernel on a pole of 2^level + 1 points;
+ * the pole is zero, which all kernels keep (they are linear), so repeated application does
+ * not produce denormals or infinities
+ */
+void BM_HierarchizationKernel(benchmark::State& state, KernelType kernel) {
+  const auto level = static_cast<LevelType>(state.range(0));
+  std::vector<real> pole((static_cast<size_t>(1) << level) + 1, 0.);
+  for (auto _ : state) {
+    kernel(pole.data(), level, 0);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(pole.size()));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(pole.size() * sizeof(real)));
+}
+
+const bool kernelsRegistered = [] {
+  const std::vector<std::pair<std::string, KernelType>> kernels = {
+      {"hat", hierarchize_hat_boundary_kernel<real, false>},
+      {"hat_periodic", hierarchize_hat_boundary_kernel<real, true>},
+      {"full_weighting", hierarchize_full_weighting_boundary_kernel<real, false>},
+      {"full_weighting_periodic", hierarchize_full_weighting_boundary_kernel<real, true>},
+      {"biorthogonal", hierarchize_biorthogonal_boundary_kernel<real, false>},
+      {"biorthogonal_periodic", hierarchize_biorthogonal_boundary_kernel<real, true>},
+      {"dehierarchize_hat", dehierarchize_hat_boundary_kernel<real, false>},
+      {"dehierarchize_hat_periodic", dehierarchize_hat_boundary_kernel<real, true>},
+      {"dehierarchize_full_weighting", dehierarchize_full_weighting_boundary_kernel<real, false>},
+      {"dehierarchize_full_weighting_periodic",
+       dehierarchize_full_weighting_boundary_kernel<real, true>},
+      {"dehierarchize_biorthogonal", dehierarchize_biorthogonal_boundary_kernel<real, false>},
+      {"dehierarchize_biorthogonal_periodic",
+       dehierarchize_biorthogonal_boundary_kernel<real, true>},
+  };
+  for (const auto& nameAndKernel : kernels) {
+    benchmark::RegisterBenchmark(("BM_HierarchizationKernel/" + nameAndKernel.first).c_str(),
+                                 BM_HierarchizationKernel, nameAndKernel.second)
+        ->ArgName("level")
+        ->DenseRange(4, 20, 4);
+  }
+  return true;
+}();
+
+std::unique_ptr<BasisFunctionBasis> getBasis(int64_t basis) {
+  switch (basis) {
+    case 0:
+      return std::make_unique<HierarchicalHatBasisFunction>();
+    case 1:
+      return std::make_unique<FullWeightingBasisFunction>();
+    case 2:
+      return std::make_unique<BiorthogonalBasisFunction>();
+    default:
+      throw std::invalid_argument("unknown basis");
+  }
+}
+
+/**
+ * distributed hierarchization of a single dimension of a dfg with the same level in all
+ * dimensions, decomposed onto the given number of ranks;
+ * basis: 0 = hierarchical hat, 1 = full weighting, 2 = biorthogonal
+ */
+void BM_DistributedHierarchization(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numRanks = static_cast<int>(state.range(2));
+  const auto basis = getBasis(state.range(3));
+  const auto hierarchizedDim = static_cast<DimType>(state.range(4));
+  if (!requireRanks(state, numRanks)) return;
+
+  auto comm = getFirstRanksComm(numRanks);
+  CommunicatorType cartesianComm = MPI_COMM_NULL;
+  std::unique_ptr<OwningDistributedFullGrid<real>> dfg;
+  std::vector<bool> dims(dim, false);
+  dims[hierarchizedDim] = true;
+  std::vector<BasisFunctionBasis*> bases(dim, basis.get());
+  const LevelVector lmin(dim, 0);
+  if (comm != MPI_COMM_NULL) {
+    std::vector<int> procs;
+    cartesianComm = getCartesianComm(comm, dim, procs);
+    dfg = std::make_unique<OwningDistributedFullGrid<real>>(
+        dim, LevelVector(dim, level), cartesianComm, std::vector<BoundaryType>(dim, 2), procs);
+  }
+  runCollectively(state, comm, [&]() {
+    DistributedHierarchization::hierarchize<real>(*dfg, dims, bases, lmin);
+  });
+  if (dfg) {
+    state.counters["local_points"] = static_cast<double>(dfg->getNrLocalElements());
+  }
+  dfg.reset();
+}
+
+void distributedHierarchizationArguments(benchmark::internal::Benchmark* b) {
+  const std::vector<std::pair<int64_t, int64_t>> dimAndLevel = {{2, 11}, {3, 7}, {4, 5}, {6, 3}};
+  for (const auto& dl : dimAndLevel) {
+    for (int64_t ranks : {1, 2, 4, 8}) {
+      for (int64_t basis : {0, 1, 2}) {
+        for (int64_t d = 0; d < dl.first; ++d) {
+          b->Args({dl.first, dl.second, ranks, basis, d});
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_DistributedHierarchization)
+    ->ArgNames({"dim", "level", "ranks", "basis", "hierarchized_dim"})
+    ->Apply(distributedHierarchizationArguments)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
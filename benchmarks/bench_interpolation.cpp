@@ -0,0 +1,156 @@
+#include <memory>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "fullgrid/DistributedFullGrid.hpp"
+
+using namespace combigrid;
+using namespace combigrid::benchmarks;
+
+namespace {
+
+/** evaluation of num_points random points on a dfg of the same level in all dimensions */
+void BM_EvalLocal(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numPoints = static_cast<size_t>(state.range(2));
+
+  std::vector<int> procs;
+  auto selfComm = getCartesianComm(MPI_COMM_SELF, dim, procs);
+  {
+    OwningDistributedFullGrid<CombiDataType> dfg(dim, LevelVector(dim, level), selfComm,
+                                                 std::vector<BoundaryType>(dim, 2), procs);
+    for (IndexType i = 0; i < dfg.getNrLocalElements(); ++i) {
+      dfg.getData()[i] = static_cast<real>(i % 7);
+    }
+    const auto coordinates = getRandomCoordinates(numPoints, dim);
+    CombiDataType value;
+    for (auto _ : state) {
+      for (const auto& coordinate : coordinates) {
+        dfg.evalLocal(coordinate, value);
+        benchmark::DoNotOptimize(value);
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(numPoints));
+  }
+}
+
+/** the same as BM_EvalLocal, but through evalLocalBatch on structure-of-arrays coordinates */
+void BM_EvalLocalBatch(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numPoints = static_cast<size_t>(state.range(2));
+
+  std::vector<int> procs;
+  auto selfComm = getCartesianComm(MPI_COMM_SELF, dim, procs);
+  {
+    OwningDistributedFullGrid<CombiDataType> dfg(dim, LevelVector(dim, level), selfComm,
+                                                 std::vector<BoundaryType>(dim, 2), procs);
+    for (IndexType i = 0; i < dfg.getNrLocalElements(); ++i) {
+      dfg.getData()[i] = static_cast<real>(i % 7);
+    }
+    const auto coordinates = getRandomCoordinates(numPoints, dim);
+    const auto batchSize = DistributedFullGrid<CombiDataType>::evalBatchSize;
+    const auto numBatches = (numPoints + batchSize - 1) / batchSize;
+    std::vector<real> coordinatesSoA(numBatches * dim * batchSize);
+    for (size_t batch = 0; batch < numBatches; ++batch) {
+      getCoordinatesAsStructureOfArrays(coordinates, batch * batchSize,
+                                        std::min(batchSize, numPoints - batch * batchSize),
+                                        batchSize, coordinatesSoA.data() + batch * dim * batchSize);
+    }
+    std::vector<CombiDataType> values(numPoints);
+    for (auto _ : state) {
+      for (size_t batch = 0; batch < numBatches; ++batch) {
+        dfg.evalLocalBatch(coordinatesSoA.data() + batch * dim * batchSize,
+                           std::min(batchSize, numPoints - batch * batchSize), batchSize,
+                           values.data() + batch * batchSize);
+      }
+      benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(numPoints));
+  }
+}
+
+/** the same as BM_EvalLocalBatch, but by applying a precomputed interpolation plan */
+void BM_InterpolationPlanApply(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numPoints = static_cast<size_t>(state.range(2));
+
+  std::vector<int> procs;
+  auto selfComm = getCartesianComm(MPI_COMM_SELF, dim, procs);
+  {
+    OwningDistributedFullGrid<CombiDataType> dfg(dim, LevelVector(dim, level), selfComm,
+                                                 std::vector<BoundaryType>(dim, 2), procs);
+    for (IndexType i = 0; i < dfg.getNrLocalElements(); ++i) {
+      dfg.getData()[i] = static_cast<real>(i % 7);
+    }
+    const auto plan = dfg.getInterpolationPlan(getRandomCoordinates(numPoints, dim));
+    std::vector<CombiDataType> values(numPoints);
+    for (auto _ : state) {
+      plan.apply(dfg.getData(), values.data());
+      benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(numPoints));
+  }
+}
+
+/**
+ * DistributedFullGrid::getInterpolatedValues, the per-task part of interpolateValues:
+ * local evaluation on a dfg decomposed onto the given number of ranks and reduction in its
+ * communicator
+ */
+void BM_InterpolateValues(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numRanks = static_cast<int>(state.range(2));
+  const auto numPoints = static_cast<size_t>(state.range(3));
+  if (!requireRanks(state, numRanks)) return;
+
+  auto comm = getFirstRanksComm(numRanks);
+  CommunicatorType cartesianComm = MPI_COMM_NULL;
+  std::unique_ptr<OwningDistributedFullGrid<CombiDataType>> dfg;
+  const auto coordinates = getRandomCoordinates(numPoints, dim);
+  if (comm != MPI_COMM_NULL) {
+    std::vector<int> procs;
+    cartesianComm = getCartesianComm(comm, dim, procs);
+    dfg = std::make_unique<OwningDistributedFullGrid<CombiDataType>>(
+        dim, LevelVector(dim, level), cartesianComm, std::vector<BoundaryType>(dim, 2), procs);
+  }
+  runCollectively(state, comm, [&]() {
+    auto values = dfg->getInterpolatedValues(coordinates);
+    benchmark::DoNotOptimize(values.data());
+  });
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(numPoints));
+  dfg.reset();
+}
+
+}  // namespace
+
+BENCHMARK(BM_EvalLocal)
+    ->ArgNames({"dim", "level", "num_points"})
+    ->ArgsProduct({{2, 3, 4, 6}, {4}, {1 << 10, 1 << 14}})
+    ->Args({2, 10, 1 << 14})
+    ->Args({3, 7, 1 << 14})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_EvalLocalBatch)
+    ->ArgNames({"dim", "level", "num_points"})
+    ->ArgsProduct({{2, 3, 4, 6}, {4}, {1 << 10, 1 << 14}})
+    ->Args({2, 10, 1 << 14})
+    ->Args({3, 7, 1 << 14})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_InterpolationPlanApply)
+    ->ArgNames({"dim", "level", "num_points"})
+    ->ArgsProduct({{2, 3, 4, 6}, {4}, {1 << 10, 1 << 14}})
+    ->Args({2, 10, 1 << 14})
+    ->Args({3, 7, 1 << 14})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_InterpolateValues)
+    ->ArgNames({"dim", "level", "ranks", "num_points"})
+    ->ArgsProduct({{2}, {8}, {1, 2, 4, 8}, {1 << 10, 1 << 14}})
+    ->ArgsProduct({{4}, {4}, {1, 2, 4, 8}, {1 << 10, 1 << 14}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "io/MPIInputOutput.hpp"
+
+using namespace combigrid;
+using namespace combigrid::benchmarks;
+
+namespace {
+
+/**
+ * reading and reducing 2^log2_values values per rank from a single file, as done for the
+ * file-based third level combination, with a buffer of buffer_elements values
+ */
+void BM_ReadReduceValuesConsecutive(benchmark::State& state) {
+  const auto numValues = static_cast<MPI_Offset>(1) << state.range(0);
+  const auto numRanks = static_cast<int>(state.range(1));
+  const auto numElementsToBuffer = static_cast<int>(state.range(2));
+  if (!requireRanks(state, numRanks)) return;
+
+  auto comm = getFirstRanksComm(numRanks);
+  const std::string fileName = "discotec_bench_read_reduce.tmp";
+  std::vector<CombiDataType> values;
+  if (comm != MPI_COMM_NULL) {
+    values.assign(numValues, 1.);
+    mpiio::writeValuesConsecutive(values.data(), numValues, fileName, comm, true);
+  }
+  runCollectively(state, comm, [&]() {
+    mpiio::readReduceValuesConsecutive(values.data(), numValues, fileName, comm,
+                                       numElementsToBuffer, std::plus<CombiDataType>());
+  });
+  state.SetBytesProcessed(state.iterations() * numValues * numRanks *
+                          static_cast<int64_t>(sizeof(CombiDataType)));
+  if (comm != MPI_COMM_NULL && getCommRank(comm) == 0) {
+    std::remove(fileName.c_str());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ReadReduceValuesConsecutive)
+    ->ArgNames({"log2_values", "ranks", "buffer_elements"})
+    ->ArgsProduct({{16, 20, 22}, {1, 2, 4, 8}, {1 << 14, 1 << 20}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,192 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "combicom/CombiCom.hpp"
+#include "combischeme/CombiMinMaxScheme.hpp"
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "sparsegrid/DistributedSparseGridUniform.hpp"
+
+using namespace combigrid;
+using namespace combigrid::benchmarks;
+
+namespace {
+
+/** a dfg with the same level in all dimensions on numRanks ranks and a dsg it is registered in */
+struct FullGridAndSparseGrid {
+  FullGridAndSparseGrid(DimType dim, LevelType level, CommunicatorType comm) {
+    std::vector<int> procs;
+    cartesianComm = getCartesianComm(comm, dim, procs);
+    dfg = std::make_unique<OwningDistributedFullGrid<CombiDataType>>(
+        dim, LevelVector(dim, level), cartesianComm, std::vector<BoundaryType>(dim, 2), procs);
+    std::mt19937 generator(getCommRank(comm));
+    std::uniform_real_distribution<real> distribution(-1., 1.);
+    for (IndexType i = 0; i < dfg->getNrLocalElements(); ++i) {
+      dfg->getData()[i] = distribution(generator);
+    }
+    dsg = std::make_unique<DistributedSparseGridUniform<CombiDataType>>(
+        dim, LevelVector(dim, level), LevelVector(dim, 1), cartesianComm);
+    dsg->registerDistributedFullGrid(*dfg);
+    dsg->createSubspaceData();
+  }
+  ~FullGridAndSparseGrid() {
+    dsg.reset();
+    dfg.reset();
+  }
+
+  CommunicatorType cartesianComm = MPI_COMM_NULL;
+  std::unique_ptr<OwningDistributedFullGrid<CombiDataType>> dfg;
+  std::unique_ptr<DistributedSparseGridUniform<CombiDataType>> dsg;
+};
+
+void BM_AddDistributedFullGrid(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numRanks = static_cast<int>(state.range(2));
+  if (!requireRanks(state, numRanks)) return;
+
+  auto comm = getFirstRanksComm(numRanks);
+  std::unique_ptr<FullGridAndSparseGrid> grids;
+  if (comm != MPI_COMM_NULL) {
+    grids = std::make_unique<FullGridAndSparseGrid>(dim, level, comm);
+  }
+  runCollectively(state, comm, [&]() {
+    grids->dsg->setZero();
+    grids->dsg->addDistributedFullGrid(*grids->dfg, 1.);
+  });
+  grids.reset();
+}
+
+void BM_ExtractFromUniformSG(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numRanks = static_cast<int>(state.range(2));
+  if (!requireRanks(state, numRanks)) return;
+
+  auto comm = getFirstRanksComm(numRanks);
+  std::unique_ptr<FullGridAndSparseGrid> grids;
+  if (comm != MPI_COMM_NULL) {
+    grids = std::make_unique<FullGridAndSparseGrid>(dim, level, comm);
+    grids->dsg->addDistributedFullGrid(*grids->dfg, 1.);
+  }
+  runCollectively(state, comm, [&]() { grids->dfg->extractFromUniformSG(*grids->dsg); });
+  grids.reset();
+}
+
+void fullGridSparseGridArguments(benchmark::internal::Benchmark* b) {
+  const std::vector<std::pair<int64_t, int64_t>> dimAndLevel = {{2, 12}, {3, 8}, {4, 6}, {6, 4}};
+  for (const auto& dl : dimAndLevel) {
+    for (int64_t ranks : {1, 2, 4, 8}) {
+      b->Args({dl.first, dl.second, ranks});
+    }
+  }
+}
+
+/**
+ * the global reduce of a combination scheme with lmin = 2 and lmax = level in all dimensions,
+ * where every rank acts as one process group (of size one) and holds every ranks-th component
+ * grid; variant is the CombinationVariant, chunk_MiB the maximum MiB to send per thread
+ */
+void BM_GlobalReduce(benchmark::State& state) {
+  const auto dim = static_cast<DimType>(state.range(0));
+  const auto level = static_cast<LevelType>(state.range(1));
+  const auto numRanks = static_cast<int>(state.range(2));
+  const auto variant = static_cast<CombinationVariant>(state.range(3));
+  const auto chunkMiB = static_cast<uint32_t>(state.range(4));
+  if (!requireRanks(state, numRanks)) return;
+
+  auto comm = getFirstRanksComm(numRanks);
+  CommunicatorType selfComm = MPI_COMM_NULL;
+  std::vector<std::unique_ptr<OwningDistributedFullGrid<CombiDataType>>> dfgs;
+  std::vector<real> coefficients;
+  std::unique_ptr<DistributedSparseGridUniform<CombiDataType>> dsg;
+  if (comm != MPI_COMM_NULL) {
+    const LevelVector lmin(dim, 2);
+    const LevelVector lmax(dim, level);
+    CombiMinMaxScheme scheme(dim, lmin, lmax);
+    scheme.createClassicalCombischeme();
+    std::vector<int> procs;
+    selfComm = getCartesianComm(MPI_COMM_SELF, dim, procs);
+    dsg = std::make_unique<DistributedSparseGridUniform<CombiDataType>>(dim, lmax, lmin,
+                                                                        selfComm);
+    const auto rank = getCommRank(comm);
+    for (size_t i = static_cast<size_t>(rank); i < scheme.getCombiSpaces().size();
+         i += static_cast<size_t>(numRanks)) {
+      dfgs.push_back(std::make_unique<OwningDistributedFullGrid<CombiDataType>>(
+          dim, scheme.getCombiSpaces()[i], selfComm, std::vector<BoundaryType>(dim, 2), procs));
+      coefficients.push_back(scheme.getCoeffs()[i]);
+      dsg->registerDistributedFullGrid(*dfgs.back());
+    }
+    if (variant == CombinationVariant::sparseGridReduce) {
+      CombiCom::reduceSubspaceSizes(*dsg, comm);
+    } else if (variant == CombinationVariant::subspaceReduce) {
+      dsg->setSubspaceCommunicators(comm, rank);
+    } else {
+      dsg->setOutgroupCommunicator(comm, rank);
+    }
+    if (variant != CombinationVariant::chunkedOutgroupSparseGridReduce) {
+      dsg->createSubspaceData();
+    }
+  }
+
+  runCollectively(state, comm, [&]() {
+    if (variant == CombinationVariant::sparseGridReduce) {
+      CombiCom::distributedGlobalSparseGridReduce(*dsg, chunkMiB, MPI_PROC_NULL, comm);
+    } else if (variant == CombinationVariant::subspaceReduce ||
+               variant == CombinationVariant::outgroupSparseGridReduce) {
+      CombiCom::distributedGlobalSubspaceReduce(*dsg, chunkMiB);
+    } else if (!dsg->getSubspacesByCommunicator().empty()) {
+      // like SparseGridWorker::collectReduceDistribute, without the local operations
+      auto& chunkedSubspaces = CombiCom::getChunkedSubspaces(
+          *dsg, dsg->getSubspacesByCommunicator()[0].second,
+          CombiCom::getGlobalReduceChunkSize<CombiDataType>(chunkMiB));
+      for (auto& subspaceChunk : chunkedSubspaces) {
+        dsg->allocateDifferentSubspaces(std::move(subspaceChunk));
+        CombiCom::distributedGlobalSubspaceReduce<DistributedSparseGridUniform<CombiDataType>,
+                                                  true>(*dsg, chunkMiB);
+      }
+    }
+  });
+  if (dsg) {
+    state.counters["dsg_size"] = static_cast<double>(dsg->getAccumulatedDataSize());
+  }
+  dsg.reset();
+  dfgs.clear();
+}
+
+void globalReduceArguments(benchmark::internal::Benchmark* b) {
+  const std::vector<std::pair<int64_t, int64_t>> dimAndLevel = {{2, 10}, {3, 7}, {4, 5}};
+  for (const auto& dl : dimAndLevel) {
+    for (int64_t ranks : {2, 4, 8}) {
+      for (int64_t variant : {CombinationVariant::sparseGridReduce,
+                              CombinationVariant::subspaceReduce,
+                              CombinationVariant::outgroupSparseGridReduce,
+                              CombinationVariant::chunkedOutgroupSparseGridReduce}) {
+        for (int64_t chunkMiB : {1, 16}) {
+          b->Args({dl.first, dl.second, ranks, variant, chunkMiB});
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_AddDistributedFullGrid)
+    ->ArgNames({"dim", "level", "ranks"})
+    ->Apply(fullGridSparseGridArguments)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ExtractFromUniformSG)
+    ->ArgNames({"dim", "level", "ranks"})
+    ->Apply(fullGridSparseGridArguments)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_GlobalReduce)
+    ->ArgNames({"dim", "level", "ranks", "variant", "chunk_MiB"})
+    ->Apply(globalReduceArguments)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
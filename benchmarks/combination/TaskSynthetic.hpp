@@ -0,0 +1,84 @@
+#ifndef TASKSYNTHETIC_HPP_
+#define TASKSYNTHETIC_HPP_
+
+#include <chrono>
+#include <vector>
+
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "task/Task.hpp"
+
+namespace combigrid {
+
+/**
+ * A task that does not solve anything: its full grid holds a smooth function of the level and
+ * each run takes (at least) runCost seconds of streaming through the grid, so that the
+ * combination can be benchmarked without solver time mixing in.
+ */
+class TaskSynthetic : public Task {
+ public:
+  TaskSynthetic(const LevelVector& l, const std::vector<BoundaryType>& boundary, real coeff,
+                LoadModel* loadModel, real runCost, std::vector<int> p)
+      : Task(l, boundary, coeff, loadModel), runCost_(runCost), p_(std::move(p)), dfg_(nullptr) {}
+
+  void init(CommunicatorType lcomm,
+            std::vector<IndexVector> decomposition = std::vector<IndexVector>()) override {
+    assert(dfg_ == nullptr);
+    dfg_ = new OwningDistributedFullGrid<CombiDataType>(
+        this->getDim(), this->getLevelVector(), lcomm, this->getBoundary(), p_, false,
+        decomposition);
+    const auto value = static_cast<CombiDataType>(this->getLevelVector()[0]) /
+                       static_cast<CombiDataType>(this->getLevelVector().back());
+    auto elements = dfg_->getData();
+    for (IndexType i = 0; i < dfg_->getNrLocalElements(); ++i) {
+      elements[i] = value;
+    }
+  }
+
+  void run(CommunicatorType lcomm) override {
+    const auto start = std::chrono::steady_clock::now();
+    auto elements = dfg_->getData();
+    const auto numElements = dfg_->getNrLocalElements();
+    do {
+      for (IndexType i = 0; i < numElements; ++i) {
+        elements[i] *= 1.;
+      }
+    } while (std::chrono::duration<real>(std::chrono::steady_clock::now() - start).count() <
+             runCost_);
+    setFinished(true);
+  }
+
+  void getFullGrid(FullGrid<CombiDataType>& fg, RankType r, CommunicatorType lcomm,
+                   int n = 0) override {
+    dfg_->gatherFullGrid(fg, r);
+  }
+
+  DistributedFullGrid<CombiDataType>& getDistributedFullGrid(int n = 0) override { return *dfg_; }
+
+  void setZero() override { dfg_->setZero(); }
+
+  ~TaskSynthetic() override {
+    if (dfg_ != nullptr) delete dfg_;
+    dfg_ = nullptr;
+  }
+
+ protected:
+  TaskSynthetic() : runCost_(0.), dfg_(nullptr) {}
+
+ private:
+  friend class boost::serialization::access;
+
+  real runCost_;
+  std::vector<int> p_;
+  OwningDistributedFullGrid<CombiDataType>* dfg_;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    ar& boost::serialization::base_object<Task>(*this);
+    ar& runCost_;
+    ar& p_;
+  }
+};
+
+}  // namespace combigrid
+
+#endif  // def TASKSYNTHETIC_HPP_
@@ -0,0 +1,301 @@
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/serialization/export.hpp>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "TaskSynthetic.hpp"
+#include "combischeme/CombiMinMaxScheme.hpp"
+#include "io/BroadcastParameters.hpp"
+#include "loadmodel/LinearLoadModel.hpp"
+#include "manager/CombiParameters.hpp"
+#include "manager/ProcessGroupWorker.hpp"
+#include "mpi/MPIMemory.hpp"
+#include "mpi/MPISystem.hpp"
+#include "utils/Stats.hpp"
+#include "utils/Types.hpp"
+
+using namespace combigrid;
+
+// this is necessary for correct function of task serialization
+#include "utils/BoostExports.hpp"
+BOOST_CLASS_EXPORT(TaskSynthetic)
+
+namespace {
+
+/** one point in the parameter sweep */
+struct Configuration {
+  DimType dim;
+  LevelType lmin;
+  LevelType lmax;
+  size_t ngroup;
+  size_t nprocs;
+  CombinationVariant variant;
+  uint32_t chunkSizeInMebibyte;
+};
+
+/** the per-combination times (maximum over all ranks, averaged over the combinations) */
+struct Result {
+  Configuration configuration;
+  long long numDOF = 0;
+  double run = 0.;
+  double hierarchize = 0.;
+  double localReduce = 0.;
+  double globalReduce = 0.;
+  double reduceDistribute = 0.;  // chunked variant: local + global reduce and extract, fused
+  double extract = 0.;
+  double dehierarchize = 0.;
+  double combine = 0.;
+  unsigned long maxHighWaterMarkKB = 0;
+  unsigned long sumHighWaterMarkKB = 0;
+  double strongScalingEfficiency = std::numeric_limits<double>::quiet_NaN();
+  double weakScalingEfficiency = std::numeric_limits<double>::quiet_NaN();
+};
+
+/** the duration of the last event with this name in seconds, 0 if there is none */
+double getLastEventSeconds(const std::string& name) {
+#ifdef TIMING
+  if (Stats::getDuration(name) == std::numeric_limits<long unsigned int>::max()) {
+    return 0.;
+  }
+  return static_cast<double>(Stats::getEventDurationInUsec(Stats::getEvent(name))) * 1e-6;
+#else
+  return 0.;
+#endif
+}
+
+double getMaxOverComm(double value, CommunicatorType comm) {
+  MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return value;
+}
+
+/**
+ * run ncombi combinations of the synthetic tasks in one configuration, on the first
+ * ngroup * nprocs ranks of MPI_COMM_WORLD; only valid on rank 0
+ */
+Result runConfiguration(const Configuration& c, size_t ncombi, real runCost) {
+  Result result;
+  result.configuration = c;
+  // the MPISystem keeps using the world communicator it was initialized with, so keep them
+  static std::map<int, CommunicatorType> comms;
+  const auto numRanks = static_cast<int>(c.ngroup * c.nprocs);
+  if (comms.find(numRanks) == comms.end()) {
+    int worldRank = getCommRank(MPI_COMM_WORLD);
+    MPI_Comm_split(MPI_COMM_WORLD, worldRank < numRanks ? 0 : MPI_UNDEFINED, worldRank,
+                   &comms[numRanks]);
+  }
+  CommunicatorType comm = comms[numRanks];
+  if (comm == MPI_COMM_NULL) {
+    return result;
+  }
+  mpimemory::reset_memory_high_water_mark();
+  theMPISystem()->initWorldReusable(comm, c.ngroup, c.nprocs, false, false);
+  {
+    const LevelVector lmin(c.dim, c.lmin);
+    const LevelVector lmax(c.dim, c.lmax);
+    const std::vector<BoundaryType> boundary(c.dim, 1);
+    std::vector<int> p(c.dim, 0);
+    MPI_Dims_create(static_cast<int>(c.nprocs), static_cast<int>(c.dim), p.data());
+
+    CombiMinMaxScheme scheme(c.dim, lmin, lmax);
+    scheme.createClassicalCombischeme();
+    for (const auto& level : scheme.getCombiSpaces()) {
+      result.numDOF += getCombiDegreesOfFreedom(level, boundary);
+    }
+    std::vector<LevelVector> levels;
+    std::vector<combigrid::real> coeffs;
+    std::vector<size_t> taskNumbers;
+    getLoadBalancedLevels(scheme, theMPISystem()->getProcessGroupNumber(), c.ngroup, boundary,
+                          levels, coeffs, taskNumbers);
+
+    auto boundaryCopy = boundary;
+    CombiParameters params(c.dim, lmin, lmax, boundaryCopy, static_cast<IndexType>(ncombi), 1,
+                           c.variant, p, LevelVector(c.dim, 0), LevelVector(c.dim, 1),
+                           c.chunkSizeInMebibyte, false);
+    setCombiParametersHierarchicalBasesUniform(params, "hat_periodic");
+    IndexVector maxNumPoints(c.dim);
+    for (DimType d = 0; d < c.dim; ++d) {
+      maxNumPoints[d] = combigrid::getNumDofNodal(lmax[d], boundary[d]);
+    }
+    params.setDecomposition(combigrid::getDefaultDecomposition(maxNumPoints, p, false));
+
+    auto loadmodel = std::unique_ptr<LoadModel>(new LinearLoadModel());
+    ProcessGroupWorker worker;
+    worker.setCombiParameters(std::move(params));
+    worker.initializeAllTasks<TaskSynthetic>(levels, coeffs, taskNumbers, loadmodel.get(),
+                                             runCost, p);
+    worker.initCombinedDSGVector();
+    worker.zeroDsgsData();
+
+    for (size_t i = 0; i < ncombi; ++i) {
+      MPI_Barrier(comm);
+      auto start = MPI_Wtime();
+      worker.runAllTasks();
+      result.run += getMaxOverComm(MPI_Wtime() - start, comm);
+
+      MPI_Barrier(comm);
+      start = MPI_Wtime();
+      worker.combineAtOnce();
+      result.combine += getMaxOverComm(MPI_Wtime() - start, comm);
+      result.hierarchize += getMaxOverComm(getLastEventSeconds("hierarchize"), comm);
+      if (c.variant == CombinationVariant::chunkedOutgroupSparseGridReduce) {
+        result.reduceDistribute += getMaxOverComm(getLastEventSeconds("reduce/distribute"), comm);
+      } else {
+        result.localReduce += getMaxOverComm(getLastEventSeconds("local reduce"), comm);
+        result.globalReduce += getMaxOverComm(getLastEventSeconds("global reduce"), comm);
+        result.extract += getMaxOverComm(getLastEventSeconds("distribute"), comm);
+      }
+      result.dehierarchize += getMaxOverComm(getLastEventSeconds("dehierarchize"), comm);
+    }
+    worker.exit();
+  }
+  mpimemory::get_all_memory_high_water_mark_kb(&result.maxHighWaterMarkKB,
+                                               &result.sumHighWaterMarkKB, comm);
+  for (auto* time : {&result.run, &result.hierarchize, &result.localReduce, &result.globalReduce,
+                     &result.reduceDistribute, &result.extract, &result.dehierarchize,
+                     &result.combine}) {
+    *time /= static_cast<double>(ncombi);
+  }
+  return result;
+}
+
+/**
+ * strong scaling: combination time relative to the run of the same problem (dim, lmin, lmax,
+ * variant, chunk size) on the fewest ranks; weak scaling: combined degrees of freedom per rank
+ * and second, relative to the run with the fewest ranks with the same dim, variant and chunk
+ * size
+ */
+void setScalingEfficiencies(std::vector<Result>& results) {
+  auto ranks = [](const Result& r) {
+    return static_cast<double>(r.configuration.ngroup * r.configuration.nprocs);
+  };
+  std::map<std::tuple<DimType, LevelType, LevelType, int, uint32_t>, const Result*> strongBase;
+  std::map<std::tuple<DimType, int, uint32_t>, const Result*> weakBase;
+  for (const auto& r : results) {
+    const auto& c = r.configuration;
+    auto& s = strongBase[{c.dim, c.lmin, c.lmax, static_cast<int>(c.variant),
+                          c.chunkSizeInMebibyte}];
+    if (s == nullptr || ranks(*s) > ranks(r)) s = &r;
+    auto& w = weakBase[{c.dim, static_cast<int>(c.variant), c.chunkSizeInMebibyte}];
+    if (w == nullptr || ranks(*w) > ranks(r)) w = &r;
+  }
+  for (auto& r : results) {
+    const auto& c = r.configuration;
+    const auto* s = strongBase[{c.dim, c.lmin, c.lmax, static_cast<int>(c.variant),
+                                c.chunkSizeInMebibyte}];
+    r.strongScalingEfficiency = (s->combine * ranks(*s)) / (r.combine * ranks(r));
+    const auto* w = weakBase[{c.dim, static_cast<int>(c.variant), c.chunkSizeInMebibyte}];
+    r.weakScalingEfficiency = (static_cast<double>(r.numDOF) / ranks(r) / r.combine) /
+                              (static_cast<double>(w->numDOF) / ranks(*w) / w->combine);
+  }
+}
+
+void writeResults(const std::vector<Result>& results, std::ostream& out) {
+  out << "dim,lmin,lmax,ngroup,nprocs,ranks,variant,chunk_MiB,dofs,run_s,hierarchize_s,"
+         "local_reduce_s,global_reduce_s,reduce_distribute_s,extract_s,dehierarchize_s,"
+         "combine_s,hwm_max_kB,hwm_sum_kB,strong_efficiency,weak_efficiency\n";
+  out << std::setprecision(6);
+  for (const auto& r : results) {
+    const auto& c = r.configuration;
+    out << static_cast<int>(c.dim) << "," << static_cast<int>(c.lmin) << ","
+        << static_cast<int>(c.lmax) << "," << c.ngroup << "," << c.nprocs << ","
+        << c.ngroup * c.nprocs << "," << static_cast<int>(c.variant) << ","
+        << c.chunkSizeInMebibyte << "," << r.numDOF << "," << r.run << "," << r.hierarchize << ","
+        << r.localReduce << "," << r.globalReduce << "," << r.reduceDistribute << ","
+        << r.extract << "," << r.dehierarchize << "," << r.combine << ","
+        << r.maxHighWaterMarkKB << "," << r.sumHighWaterMarkKB << ","
+        << r.strongScalingEfficiency << "," << r.weakScalingEfficiency << "\n";
+  }
+}
+
+template <typename T>
+std::vector<T> getList(const boost::property_tree::ptree& cfg, const std::string& key,
+                       const std::string& defaultValue) {
+  std::vector<T> values;
+  std::istringstream stream(cfg.get<std::string>(key, defaultValue));
+  long long value;
+  while (stream >> value) {
+    values.push_back(static_cast<T>(value));
+  }
+  return values;
+}
+
+}  // namespace
+
+/**
+ * Benchmarks the combination (hierarchize, reduce, extract, dehierarchize) on synthetic tasks
+ * for all combinations of the values given in the [sweep] section of the parameter file, cf.
+ * ctparam. Each configuration runs on the first ngroup * nprocs ranks of MPI_COMM_WORLD,
+ * configurations that need more ranks are skipped. The results are written as CSV to stdout
+ * and to the file given as [output] file.
+ */
+int main(int argc, char** argv) {
+  [[maybe_unused]] auto mpiOnOff = MpiOnOff(&argc, &argv);
+  Stats::initialize();
+
+  std::string paramfile = "ctparam";
+  if (argc > 1) paramfile = argv[1];
+  boost::property_tree::ptree cfg =
+      broadcastParameters::getParametersFromRankZero(paramfile, MPI_COMM_WORLD);
+
+  const auto dims = getList<DimType>(cfg, "sweep.dim", "2");
+  const auto lmins = getList<LevelType>(cfg, "sweep.lmin", "2");
+  const auto lmaxs = getList<LevelType>(cfg, "sweep.lmax", "6");
+  const auto ngroups = getList<size_t>(cfg, "sweep.ngroup", "1");
+  const auto nprocss = getList<size_t>(cfg, "sweep.nprocs", "1");
+  const auto variants = getList<int>(cfg, "sweep.variant", "0");
+  const auto chunkSizes = getList<uint32_t>(cfg, "sweep.chunkSize", "64");
+  const auto ncombi = cfg.get<size_t>("sweep.ncombi", 3);
+  const auto runCost = cfg.get<real>("sweep.runCost", 0.);
+  const auto outputFile = cfg.get<std::string>("output.file", "combination_bench.csv");
+
+  const auto worldSize = static_cast<size_t>(getCommSize(MPI_COMM_WORLD));
+  const bool isRoot = getCommRank(MPI_COMM_WORLD) == 0;
+#ifndef TIMING
+  if (isRoot) {
+    std::cout << "Built without TIMING, only the run and combine times are measured"
+              << std::endl;
+  }
+#endif
+
+  std::vector<Result> results;
+  for (auto dim : dims)
+    for (auto lmin : lmins)
+      for (auto lmax : lmaxs)
+        for (auto ngroup : ngroups)
+          for (auto nprocs : nprocss)
+            for (auto variant : variants)
+              for (auto chunkSize : chunkSizes) {
+                Configuration c{dim,    lmin, lmax, ngroup, nprocs,
+                                static_cast<CombinationVariant>(variant), chunkSize};
+                CombiMinMaxScheme scheme(dim, LevelVector(dim, lmin), LevelVector(dim, lmax));
+                scheme.createClassicalCombischeme();
+                if (lmin > lmax || ngroup * nprocs > worldSize ||
+                    scheme.getCombiSpaces().size() < ngroup) {
+                  if (isRoot) {
+                    std::cout << "skipping dim " << static_cast<int>(dim) << " lmin "
+                              << static_cast<int>(lmin) << " lmax " << static_cast<int>(lmax)
+                              << " on " << ngroup << "x" << nprocs << " ranks" << std::endl;
+                  }
+                  continue;
+                }
+                results.push_back(runConfiguration(c, ncombi, runCost));
+                MPI_Barrier(MPI_COMM_WORLD);
+              }
+
+  if (isRoot) {
+    setScalingEfficiencies(results);
+    writeResults(results, std::cout);
+    std::ofstream out(outputFile);
+    writeResults(results, out);
+  }
+  Stats::finalize();
+  return 0;
+}
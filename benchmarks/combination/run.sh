@@ -0,0 +1,13 @@
+#!/bin/bash
+# runs the combination benchmark sweep on a single node;
+# oversubscription is allowed so that all configurations up to 8 ranks can run on any machine
+NRANKS=${NRANKS:-8}
+PARAMFILE=${1:-ctparam}
+
+echo $(git log -1 --pretty=format:"%H")
+
+cat $PARAMFILE
+
+export OMP_NUM_THREADS=${OMP_NUM_THREADS:-1}
+
+mpiexec --oversubscribe -n $NRANKS ./combination_bench $PARAMFILE
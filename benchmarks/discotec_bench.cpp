@@ -0,0 +1,54 @@
+// to resolve https://github.com/open-mpi/ompi/issues/5157
+#define OMPI_SKIP_MPICXX 1
+#include <mpi.h>
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+/** discards all results, used on all ranks but the first */
+class NullReporter : public benchmark::BenchmarkReporter {
+ public:
+  bool ReportContext(const Context&) override { return true; }
+  void ReportRuns(const std::vector<Run>&) override {}
+};
+}  // namespace
+
+/**
+ * Runs the benchmarks registered in the bench_*.cpp files. The benchmarks that communicate use
+ * (a subset of) MPI_COMM_WORLD; so run this with as many ranks as the largest rank count
+ * benchmarked, e.g. `mpirun -np 8 ./discotec_bench --benchmark_format=json`.
+ * Only the first rank reports, all Google Benchmark flags can be used there.
+ */
+int main(int argc, char** argv) {
+  MPI_Init(&argc, &argv);
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // only the first rank may write an output file
+  std::vector<char*> args;
+  for (int i = 0; i < argc; ++i) {
+    if (rank != 0 && std::strncmp(argv[i], "--benchmark_out", 15) == 0) continue;
+    args.push_back(argv[i]);
+  }
+  int numArgs = static_cast<int>(args.size());
+
+  benchmark::Initialize(&numArgs, args.data());
+  if (benchmark::ReportUnrecognizedArguments(numArgs, args.data())) {
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  benchmark::AddCustomContext("mpi_ranks", std::to_string(size));
+
+  if (rank == 0) {
+    benchmark::RunSpecifiedBenchmarks();
+  } else {
+    NullReporter nullReporter;
+    benchmark::RunSpecifiedBenchmarks(&nullReporter);
+  }
+  benchmark::Shutdown();
+  MPI_Finalize();
+  return 0;
+}
@@ -24,6 +24,7 @@
 #include "manager/ProcessGroupWorker.hpp"
 #include "manager/ProcessManager.hpp"
 #include "task/Task.hpp"
+#include "utils/Tracing.hpp"
 #include "utils/Types.hpp"
 // include user specific task. this is the interface to your application
 #include "TaskExample.hpp"
@@ -41,6 +42,7 @@ int main(int argc, char** argv) {
    * initialized at the beginning of the program. (and finalized in the end)
    */
   Stats::initialize();
+  Tracing::initialize();
 
   // only one rank reads inputs and broadcasts to others
   std::string paramfile = "ctparam";
@@ -181,9 +183,12 @@ int main(int argc, char** argv) {
   }
 
   Stats::finalize();
+  Tracing::finalize();
 
   /* write stats to json file for postprocessing */
   Stats::write("timers.json");
+  /* write fine-grained traces, can be opened with https://ui.perfetto.dev */
+  Tracing::writeChromeTrace("trace.json");
 
   return 0;
 }
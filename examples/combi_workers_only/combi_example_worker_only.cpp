@@ -121,6 +121,8 @@ int main(int argc, char** argv) {
                            LevelVector(dim, 0), reduceCombinationDimsLmax, chunkSizeInMebibyte,
                            forwardDecomposition);
     setCombiParametersHierarchicalBasesUniform(params, basis);
+    // bitwise reproducible combination, e.g. for regression tests of restarts
+    params.setReduceReproducible(cfg.get<bool>("ct.reproducibleReduce", false));
     IndexVector minNumPoints(dim), maxNumPoints(dim);
     for (DimType d = 0; d < dim; ++d) {
       minNumPoints[d] = combigrid::getNumDofNodal(lmin[d], boundary[d]);
@@ -167,6 +169,16 @@ int main(int argc, char** argv) {
     MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << getTimeStamp() << "worker: initialized tasks "
                                                << std::endl;
 
+    // optionally, let the worker choose combination variant and chunk size
+    if (cfg.get_child_optional("ct.tuningFile")) {
+      auto [variant, chunkSize] = worker.tuneCombination(
+          cfg.get<std::string>("ct.tuningFile"), cfg.get<uint32_t>("ct.memoryBudget", 0));
+      chunkSizeInMebibyte = chunkSize;
+      MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << getTimeStamp() << "worker: tuned to variant "
+                                                 << static_cast<int>(variant) << " and "
+                                                 << chunkSize << " MiB chunks" << std::endl;
+    }
+
     worker.initCombinedDSGVector();
     MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << getTimeStamp() << "worker: initialized SG"
                                                << std::endl;
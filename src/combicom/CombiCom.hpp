@@ -1,11 +1,14 @@
 #ifndef COMBICOM_HPP_
 #define COMBICOM_HPP_
 
+#include "combicom/ReproducibleSum.hpp"
 #include "fullgrid/DistributedFullGrid.hpp"
 #include "fullgrid/FullGrid.hpp"
+#include "mpi/CommunicationCounters.hpp"
 #include "mpi/MPISystem.hpp"
 #include "mpi/MPITags.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
+#include "utils/Tracing.hpp"
 
 namespace combigrid {
 
@@ -101,6 +104,35 @@ static int getGlobalReduceChunkSize(uint32_t maxMiBToSendPerThread) {
   return chunkSize;
 }
 
+/** the chunk size in elements for reproducibleReduce, which sends fixed-point values */
+template <typename SG_ELEMENT>
+static int getReproducibleReduceChunkSize(uint32_t maxMiBToSendPerThread) {
+  return std::max(1, getGlobalReduceChunkSize<FixedPointValue>(maxMiBToSendPerThread) /
+                         RealComponents<SG_ELEMENT>::numComponents);
+}
+
+/**
+ * @brief gathers the Kahan terms of the values in [offset, offset + count) of the sparse grid's
+ * raw data (zero where there are none)
+ */
+template <typename SparseGridType>
+void getKahanTermsInRawRange(SparseGridType& dsg, size_t offset, size_t count,
+                             std::vector<typename SparseGridType::ElementType>& kahanTerms) {
+  kahanTerms.assign(count, typename SparseGridType::ElementType(0.));
+  for (typename SparseGridType::SubspaceIndexType i = 0; i < dsg.getNumSubspaces(); ++i) {
+    const auto* kahanData = dsg.getKahanData(i);
+    if (kahanData == nullptr || dsg.getDataSize(i) == 0) continue;
+    const size_t subspaceBegin = dsg.getData(i) - dsg.getRawData();
+    const size_t subspaceEnd = subspaceBegin + dsg.getDataSize(i);
+    const size_t begin = std::max(subspaceBegin, offset);
+    const size_t end = std::min(subspaceEnd, offset + count);
+    if (begin < end) {
+      std::copy(kahanData + (begin - subspaceBegin), kahanData + (end - subspaceBegin),
+                kahanTerms.begin() + (begin - offset));
+    }
+  }
+}
+
 /*** In this method the global reduction of the distributed sparse grid is
  * performed. The global sparse grid is decomposed geometrically according to
  * the domain decomposition (see Variant 2 in chapter 3.3.3 in marios diss). We
@@ -108,12 +140,14 @@ static int getGlobalReduceChunkSize(uint32_t maxMiBToSendPerThread) {
  * subspaces with 0. We then perform an MPI_Allreduce with all processes from
  * other process groups that own the same geometrical area. Here we follow the
  * Sparse Grid Reduce strategy from chapter 2.7.2 in marios diss.
+ * If reproducible, the (Kahan-compensated) values are summed exactly with reproducibleReduce
+ * instead of MPI_SUM, so the result does not depend on the reduction algorithm.
  */
 template <typename SparseGridType>
 void distributedGlobalSparseGridReduce(
     SparseGridType& dsg, uint32_t maxMiBToSendPerThread,
     RankType globalReduceRankThatCollects = MPI_PROC_NULL,
-    MPI_Comm globalComm = theMPISystem()->getGlobalReduceComm()) {
+    MPI_Comm globalComm = theMPISystem()->getGlobalReduceComm(), bool reproducible = false) {
   assert(globalComm != MPI_COMM_NULL);
   assert(dsg.isSubspaceDataCreated() && "Only perform reduce with allocated data");
 
@@ -126,39 +160,60 @@ void distributedGlobalSparseGridReduce(
       abstraction::getabstractionDataType<typename SparseGridType::ElementType>());
 
   auto chunkSize =
-      getGlobalReduceChunkSize<typename SparseGridType::ElementType>(maxMiBToSendPerThread);
-  size_t sentRecvd = 0;
-  if (globalReduceRankThatCollects == MPI_PROC_NULL) {
-    while ((subspacesDataSize - sentRecvd) / chunkSize > 0) {
-      MPI_Allreduce(MPI_IN_PLACE, subspacesData + sentRecvd, static_cast<int>(chunkSize), dtype,
-                    MPI_SUM, globalComm);
-      sentRecvd += chunkSize;
+      reproducible
+          ? getReproducibleReduceChunkSize<typename SparseGridType::ElementType>(
+                maxMiBToSendPerThread)
+          : getGlobalReduceChunkSize<typename SparseGridType::ElementType>(maxMiBToSendPerThread);
+  CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::globalReduce);
+  if (reproducible) {
+    // sum the Kahan-compensated values exactly, chunk by chunk
+    MPI_Datatype fixedPointType = getFixedPointDatatype();
+    MPI_Op fixedPointAdd;
+    MPI_Op_create(addFixedPointValues, true, &fixedPointAdd);
+    std::vector<typename SparseGridType::ElementType> compensation;
+    for (size_t offset = 0; offset < subspacesDataSize; offset += chunkSize) {
+      const auto count = std::min(static_cast<size_t>(chunkSize), subspacesDataSize - offset);
+      getKahanTermsInRawRange(dsg, offset, count, compensation);
+      reproducibleReduce(subspacesData + offset, compensation.data(), static_cast<int>(count),
+                         globalReduceRankThatCollects, globalComm, fixedPointAdd, fixedPointType);
     }
-    MPI_Allreduce(MPI_IN_PLACE, subspacesData + sentRecvd,
-                  static_cast<int>(subspacesDataSize - sentRecvd), dtype, MPI_SUM, globalComm);
-  } else {
-    if (theMPISystem()->getGlobalReduceRank() == globalReduceRankThatCollects) {
-      // I am the reduce rank that collects the data
-      while ((subspacesDataSize - sentRecvd) / chunkSize > 0) {
-        MPI_Reduce(MPI_IN_PLACE, subspacesData + sentRecvd, static_cast<int>(chunkSize), dtype,
-                   MPI_SUM, globalReduceRankThatCollects, globalComm);
-        sentRecvd += chunkSize;
+    if (globalReduceRankThatCollects == MPI_PROC_NULL ||
+        getCommRank(globalComm) == globalReduceRankThatCollects) {
+      for (typename SparseGridType::SubspaceIndexType i = 0; i < dsg.getNumSubspaces(); ++i) {
+        if (dsg.getKahanData(i) != nullptr) {
+          std::fill_n(dsg.getKahanData(i), dsg.getDataSize(i),
+                      typename SparseGridType::ElementType(0.));
+        }
       }
-      MPI_Reduce(MPI_IN_PLACE, subspacesData + sentRecvd,
-                 static_cast<int>(subspacesDataSize - sentRecvd), dtype, MPI_SUM,
+    }
+    MPI_Op_free(&fixedPointAdd);
+    MPI_Type_free(&fixedPointType);
+    return;
+  }
+  auto reduceChunk = [&](size_t offset, int count) {
+    TRACE_SCOPE(chunkScope, "global reduce chunk");
+    const uint64_t chunkBytes =
+        static_cast<uint64_t>(count) * sizeof(typename SparseGridType::ElementType);
+    chunkScope.addBytes(chunkBytes);
+    CommunicationCounters::WaitTimer waitTimer(globalComm, 1, chunkBytes);
+    if (globalReduceRankThatCollects == MPI_PROC_NULL) {
+      MPI_Allreduce(MPI_IN_PLACE, subspacesData + offset, count, dtype, MPI_SUM, globalComm);
+    } else if (theMPISystem()->getGlobalReduceRank() == globalReduceRankThatCollects) {
+      // I am the reduce rank that collects the data
+      MPI_Reduce(MPI_IN_PLACE, subspacesData + offset, count, dtype, MPI_SUM,
                  globalReduceRankThatCollects, globalComm);
     } else {
       // I only need to send
-      while ((subspacesDataSize - sentRecvd) / chunkSize > 0) {
-        MPI_Reduce(subspacesData + sentRecvd, MPI_IN_PLACE, static_cast<int>(chunkSize), dtype,
-                   MPI_SUM, globalReduceRankThatCollects, globalComm);
-        sentRecvd += chunkSize;
-      }
-      MPI_Reduce(subspacesData + sentRecvd, MPI_IN_PLACE,
-                 static_cast<int>(subspacesDataSize - sentRecvd), dtype, MPI_SUM,
+      MPI_Reduce(subspacesData + offset, MPI_IN_PLACE, count, dtype, MPI_SUM,
                  globalReduceRankThatCollects, globalComm);
     }
+  };
+  size_t sentRecvd = 0;
+  while ((subspacesDataSize - sentRecvd) / chunkSize > 0) {
+    reduceChunk(sentRecvd, static_cast<int>(chunkSize));
+    sentRecvd += chunkSize;
   }
+  reduceChunk(sentRecvd, static_cast<int>(subspacesDataSize - sentRecvd));
 }
 
 // cf. https://stackoverflow.com/a/29286769
@@ -270,9 +325,78 @@ getReductionDatatypes(const DistributedSparseGridUniform<FG_ELEMENT>& dsg,
   return datatypesByStartIndex;
 }
 
+/**
+ * @brief distributedGlobalSubspaceReduce with reproducibleReduce: the subspaces of each chunk are
+ * packed into a contiguous buffer (with their Kahan terms), summed exactly, and unpacked again
+ */
+template <typename SparseGridType, bool communicateAllAllocated = false>
+void reproducibleGlobalSubspaceReduce(SparseGridType& dsg, uint32_t maxMiBToSendPerThread,
+                                      RankType globalReduceRankThatCollects = MPI_PROC_NULL) {
+  using ElementType = typename SparseGridType::ElementType;
+  assert(dsg.isSubspaceDataCreated() && "Only perform reduce with allocated data");
+
+  MPI_Datatype fixedPointType = getFixedPointDatatype();
+  MPI_Op fixedPointAdd;
+  MPI_Op_create(addFixedPointValues, true, &fixedPointAdd);
+  const auto chunkSize = getReproducibleReduceChunkSize<ElementType>(maxMiBToSendPerThread);
+
+#pragma omp parallel if (dsg.getSubspacesByCommunicator().size() > 1) \
+    shared(dsg, fixedPointAdd, fixedPointType)
+#pragma omp for schedule(dynamic)
+  for (size_t commIndex = 0; commIndex < dsg.getSubspacesByCommunicator().size(); ++commIndex) {
+    const auto& commAndItsSubspaces = dsg.getSubspacesByCommunicator()[commIndex];
+    const auto& comm = commAndItsSubspaces.first;
+    CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::globalReduce);
+
+    std::vector<std::set<typename AnyDistributedSparseGrid::SubspaceIndexType>> chunkedSubspaces;
+    if constexpr (communicateAllAllocated) {
+      chunkedSubspaces = getChunkedSubspaces(dsg, dsg.getCurrentlyAllocatedSubspaces(), chunkSize);
+    } else {
+      chunkedSubspaces = getChunkedSubspaces(dsg, commAndItsSubspaces.second, chunkSize);
+    }
+    const bool isReceiving = globalReduceRankThatCollects == MPI_PROC_NULL ||
+                             getCommRank(comm) == globalReduceRankThatCollects;
+    std::vector<ElementType> values, compensation;
+    for (const auto& subspacesChunk : chunkedSubspaces) {
+      values.clear();
+      compensation.clear();
+      for (const auto& ss : subspacesChunk) {
+        values.insert(values.end(), dsg.getData(ss), dsg.getData(ss) + dsg.getDataSize(ss));
+        const auto* kahanData = dsg.getKahanData(ss);
+        if (kahanData != nullptr) {
+          compensation.insert(compensation.end(), kahanData, kahanData + dsg.getDataSize(ss));
+        } else {
+          compensation.insert(compensation.end(), dsg.getDataSize(ss), ElementType(0.));
+        }
+      }
+      reproducibleReduce(values.data(), compensation.data(), static_cast<int>(values.size()),
+                         globalReduceRankThatCollects, comm, fixedPointAdd, fixedPointType);
+      if (isReceiving) {
+        auto valueIt = values.cbegin();
+        for (const auto& ss : subspacesChunk) {
+          std::copy_n(valueIt, dsg.getDataSize(ss), dsg.getData(ss));
+          if (dsg.getKahanData(ss) != nullptr) {
+            std::fill_n(dsg.getKahanData(ss), dsg.getDataSize(ss), ElementType(0.));
+          }
+          valueIt += dsg.getDataSize(ss);
+        }
+      }
+    }
+  }
+
+  MPI_Op_free(&fixedPointAdd);
+  MPI_Type_free(&fixedPointType);
+}
+
 template <typename SparseGridType, bool communicateAllAllocated = false>
 void distributedGlobalSubspaceReduce(SparseGridType& dsg, uint32_t maxMiBToSendPerThread,
-                                     RankType globalReduceRankThatCollects = MPI_PROC_NULL) {
+                                     RankType globalReduceRankThatCollects = MPI_PROC_NULL,
+                                     bool reproducible = false) {
+  if (reproducible) {
+    reproducibleGlobalSubspaceReduce<SparseGridType, communicateAllAllocated>(
+        dsg, maxMiBToSendPerThread, globalReduceRankThatCollects);
+    return;
+  }
   assert(dsg.isSubspaceDataCreated() && "Only perform reduce with allocated data");
 
   MPI_Op indexedAdd;
@@ -285,6 +409,8 @@ void distributedGlobalSubspaceReduce(SparseGridType& dsg, uint32_t maxMiBToSendP
     const std::pair<CommunicatorType,
                     std::vector<typename AnyDistributedSparseGrid::SubspaceIndexType>>&
         commAndItsSubspaces = dsg.getSubspacesByCommunicator()[commIndex];
+    // the phase is per thread, so it has to be set within the parallel region
+    CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::globalReduce);
 
     // get reduction datatypes
     std::vector<std::pair<typename AnyDistributedSparseGrid::SubspaceIndexType, MPI_Datatype>>
@@ -309,6 +435,15 @@ void distributedGlobalSubspaceReduce(SparseGridType& dsg, uint32_t maxMiBToSendP
       auto& subspaceStartIndex = datatypesByStartIndex[datatypeIndex].first;
       auto& comm = commAndItsSubspaces.first;
       auto& datatype = datatypesByStartIndex[datatypeIndex].second;
+      TRACE_SCOPE(chunkScope, "subspace reduce chunk");
+      uint64_t chunkBytes = 0;
+      if (countCommunicationExplicitly || Tracing::isActive()) {
+        int datatypeSizeInBytes = 0;
+        MPI_Type_size(datatype, &datatypeSizeInBytes);
+        chunkBytes = static_cast<uint64_t>(datatypeSizeInBytes);
+        chunkScope.addBytes(chunkBytes);
+      }
+      CommunicationCounters::WaitTimer waitTimer(comm, 1, chunkBytes);
       if (globalReduceRankThatCollects == MPI_PROC_NULL) {
         // #pragma omp ordered
         auto success = MPI_Allreduce(MPI_IN_PLACE, dsg.getData(subspaceStartIndex), 1, datatype,
@@ -342,6 +477,11 @@ template <typename SparseGridType>
 static void sendDsgData(SparseGridType& dsg, RankType dest, CommunicatorType comm) {
   typename SparseGridType::ElementType* data = dsg.getRawData();
   auto dataSize = dsg.getRawDataSize();
+  TRACE_SCOPE(sendScope, "send dsg data");
+  sendScope.addBytes(dataSize * sizeof(typename SparseGridType::ElementType));
+  CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::thirdLevel);
+  CommunicationCounters::WaitTimer waitTimer(
+      comm, dataSize / INT_MAX + 1, dataSize * sizeof(typename SparseGridType::ElementType));
   MPI_Datatype dataType =
       getMPIDatatype(abstraction::getabstractionDataType<typename SparseGridType::ElementType>());
 
@@ -361,6 +501,11 @@ template <typename SparseGridType>
 static void recvDsgData(SparseGridType& dsg, RankType source, CommunicatorType comm) {
   typename SparseGridType::ElementType* data = dsg.getRawData();
   auto dataSize = dsg.getRawDataSize();
+  TRACE_SCOPE(recvScope, "recv dsg data");
+  recvScope.addBytes(dataSize * sizeof(typename SparseGridType::ElementType));
+  CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::thirdLevel);
+  CommunicationCounters::WaitTimer waitTimer(
+      comm, dataSize / INT_MAX + 1, dataSize * sizeof(typename SparseGridType::ElementType));
   MPI_Datatype dataType =
       getMPIDatatype(abstraction::getabstractionDataType<typename SparseGridType::ElementType>());
 
@@ -393,6 +538,8 @@ static void asyncBcastDsgData(SparseGridType& dsg, RankType root, CommunicatorTy
   MPI_Datatype dataType =
       getMPIDatatype(abstraction::getabstractionDataType<typename SparseGridType::ElementType>());
 
+  CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::broadcast);
+  CommunicationCounters::add(comm, 1, dataSize * sizeof(typename SparseGridType::ElementType));
   auto success = MPI_Ibcast(data, dataSize, dataType, root, comm, request);
   assert(success == MPI_SUCCESS);
 }
@@ -420,6 +567,12 @@ static void asyncBcastOutgroupDsgData(SparseGridType& dsg, RankType root, Commun
 
     auto& subspaceStartIndex = datatypesByStartIndex[0].first;
     auto& datatype = datatypesByStartIndex[0].second;
+    CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::broadcast);
+    if constexpr (countCommunicationExplicitly) {
+      int datatypeSizeInBytes = 0;
+      MPI_Type_size(datatype, &datatypeSizeInBytes);
+      CommunicationCounters::add(comm, 1, static_cast<uint64_t>(datatypeSizeInBytes));
+    }
     auto success = MPI_Ibcast(dsg.getData(subspaceStartIndex), 1, datatype, root, comm, request);
     assert(success == MPI_SUCCESS);
   }
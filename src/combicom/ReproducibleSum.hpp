@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "mpi/CommunicationCounters.hpp"
+#include "mpi/MPISystem.hpp"
+#include "utils/Tracing.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+namespace CombiCom {
+
+/**
+ * A value in two's complement fixed-point representation high + low * 2^-62, with
+ * low in [0, 2^62). Sums of these are exact and thus independent of the summation order.
+ */
+struct FixedPointValue {
+  int64_t high;
+  int64_t low;
+};
+
+/// the number of fractional bits in FixedPointValue::low
+constexpr int fixedPointLowBits = 62;
+
+/**
+ * the number of bits kept free above the largest summand, the fixed-point sum cannot overflow
+ * for up to 2^(fixedPointGuardBits-1) summands; fixed (and not derived from the number of
+ * processes), so that the result does not depend on the number of processes
+ */
+constexpr int fixedPointGuardBits = 20;
+
+/// the real type and the number of real components of an element type
+template <typename T>
+struct RealComponents {
+  using RealType = T;
+  static constexpr int numComponents = 1;
+};
+
+template <typename T>
+struct RealComponents<std::complex<T>> {
+  using RealType = T;
+  static constexpr int numComponents = 2;
+};
+
+/** the binary exponent e with |x| < 2^e, INT_MIN for zero and INT_MAX for inf/NaN */
+template <typename RealType>
+inline int getFixedPointExponent(RealType x) {
+  if (x == 0) return INT_MIN;
+  if (!std::isfinite(x)) return INT_MAX;
+  int exponent;
+  std::frexp(x, &exponent);
+  return exponent;
+}
+
+/** the shift that maps values with |x| < 2^maxExponent to |x * 2^shift| < 2^(62-guard bits) */
+inline int getFixedPointShift(int maxExponent) {
+  return fixedPointLowBits - fixedPointGuardBits - maxExponent;
+}
+
+/** x * 2^shift, truncated towards zero below 2^-62 */
+template <typename RealType>
+inline FixedPointValue toFixedPoint(RealType x, int shift) {
+  const double scaled = std::ldexp(static_cast<double>(x), shift);
+  FixedPointValue value;
+  value.high = static_cast<int64_t>(scaled);
+  // the fractional part is computed exactly
+  value.low = static_cast<int64_t>(std::ldexp(scaled - static_cast<double>(value.high),
+                                              fixedPointLowBits));
+  if (value.low < 0) {
+    value.low += int64_t(1) << fixedPointLowBits;
+    value.high -= 1;
+  }
+  return value;
+}
+
+inline void addFixedPoint(FixedPointValue& inout, const FixedPointValue& in) {
+  // both low parts are < 2^62, so their sum cannot overflow and the carry is 0 or 1
+  inout.low += in.low;
+  inout.high += in.high + (inout.low >> fixedPointLowBits);
+  inout.low &= (int64_t(1) << fixedPointLowBits) - 1;
+}
+
+/** the (deterministically rounded) value of a fixed-point number, times 2^-shift */
+inline double fromFixedPoint(const FixedPointValue& value, int shift) {
+  return std::ldexp(static_cast<double>(value.high) +
+                        std::ldexp(static_cast<double>(value.low), -fixedPointLowBits),
+                    -shift);
+}
+
+/** MPI_User_function for FixedPointValue, cf. getFixedPointDatatype */
+inline void addFixedPointValues(void* invec, void* inoutvec, int* len, MPI_Datatype* dtype) {
+  const auto* in = reinterpret_cast<const FixedPointValue*>(invec);
+  auto* inout = reinterpret_cast<FixedPointValue*>(inoutvec);
+#pragma omp simd
+  for (int i = 0; i < *len; ++i) {
+    addFixedPoint(inout[i], in[i]);
+  }
+}
+
+/** the committed MPI datatype for FixedPointValue; free with MPI_Type_free */
+inline MPI_Datatype getFixedPointDatatype() {
+  MPI_Datatype fixedPointType;
+  MPI_Type_contiguous(2, MPI_INT64_T, &fixedPointType);
+  MPI_Type_commit(&fixedPointType);
+  return fixedPointType;
+}
+
+/**
+ * @brief sums up count elements across comm, such that the result is bitwise identical
+ * regardless of the MPI reduction algorithm, the order of the processes and the number of
+ * processes the same summands are distributed to
+ *
+ * Every summand is converted to a 124-bit fixed-point number relative to the largest summand of
+ * its element, which is found by a first (exact) MPI_MAX reduction of the exponents; the
+ * fixed-point numbers are then summed exactly with integer arithmetic and rounded back only once.
+ * Only bits more than 2^-104 below the largest summand are lost (deterministically), and
+ * non-finite summands result in NaN. This costs a second reduction and 2.5 times the
+ * communication volume of an MPI_SUM reduction (20 instead of 8 bytes per double).
+ *
+ * @param values the summands, the sum is written there on the receiving ranks
+ * @param compensation optional Kahan compensation terms belonging to values (cf.
+ * DistributedSparseGridUniform::addDistributedFullGrid), which are subtracted exactly and then
+ * set to zero on the receiving ranks; may be nullptr
+ * @param root the rank that receives the sum, or MPI_PROC_NULL for all ranks
+ * @param fixedPointOp the MPI_Op created from addFixedPointValues
+ * @param fixedPointType the datatype from getFixedPointDatatype
+ */
+template <typename FG_ELEMENT>
+void reproducibleReduce(FG_ELEMENT* values, FG_ELEMENT* compensation, int count, RankType root,
+                        CommunicatorType comm, MPI_Op fixedPointOp, MPI_Datatype fixedPointType) {
+  using RealType = typename RealComponents<FG_ELEMENT>::RealType;
+  static_assert(std::numeric_limits<RealType>::digits <= 53,
+                "reproducibleReduce: only float and double are supported");
+  const int numReals = count * RealComponents<FG_ELEMENT>::numComponents;
+  auto* realValues = reinterpret_cast<RealType*>(values);
+  auto* realCompensation = reinterpret_cast<RealType*>(compensation);
+
+  TRACE_SCOPE(chunkScope, "reproducible reduce chunk");
+  const uint64_t chunkBytes =
+      static_cast<uint64_t>(numReals) * (sizeof(int) + sizeof(FixedPointValue));
+  chunkScope.addBytes(chunkBytes);
+
+  static thread_local std::vector<int> exponentsBuffer;
+  static thread_local std::vector<FixedPointValue> fixedPointBuffer;
+  exponentsBuffer.resize(numReals);
+  fixedPointBuffer.resize(numReals);
+  // plain pointers, as other threads would see their own thread_local buffers
+  int* exponents = exponentsBuffer.data();
+  FixedPointValue* fixedPointValues = fixedPointBuffer.data();
+
+#pragma omp parallel for simd schedule(static)
+  for (int i = 0; i < numReals; ++i) {
+    exponents[i] = getFixedPointExponent(realValues[i]);
+    if (realCompensation != nullptr) {
+      exponents[i] = std::max(exponents[i], getFixedPointExponent(realCompensation[i]));
+    }
+  }
+  {
+    CommunicationCounters::WaitTimer waitTimer(comm, 1, numReals * sizeof(int));
+    MPI_Allreduce(MPI_IN_PLACE, exponents, numReals, MPI_INT, MPI_MAX, comm);
+  }
+
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < numReals; ++i) {
+    FixedPointValue value{0, 0};
+    if (exponents[i] != INT_MIN && exponents[i] != INT_MAX) {
+      const int shift = getFixedPointShift(exponents[i]);
+      value = toFixedPoint(realValues[i], shift);
+      if (realCompensation != nullptr) {
+        // the Kahan sum is values - compensation
+        addFixedPoint(value, toFixedPoint(-realCompensation[i], shift));
+      }
+    }
+    fixedPointValues[i] = value;
+  }
+
+  bool isReceiving = true;
+  {
+    CommunicationCounters::WaitTimer waitTimer(comm, 1, numReals * sizeof(FixedPointValue));
+    if (root == MPI_PROC_NULL) {
+      MPI_Allreduce(MPI_IN_PLACE, fixedPointValues, numReals, fixedPointType, fixedPointOp,
+                    comm);
+    } else if (getCommRank(comm) == root) {
+      MPI_Reduce(MPI_IN_PLACE, fixedPointValues, numReals, fixedPointType, fixedPointOp,
+                 root, comm);
+    } else {
+      MPI_Reduce(fixedPointValues, nullptr, numReals, fixedPointType, fixedPointOp, root,
+                 comm);
+      isReceiving = false;
+    }
+  }
+
+  if (isReceiving) {
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numReals; ++i) {
+      if (exponents[i] == INT_MIN) {
+        realValues[i] = 0.;
+      } else if (exponents[i] == INT_MAX) {
+        realValues[i] = std::numeric_limits<RealType>::quiet_NaN();
+      } else {
+        realValues[i] = static_cast<RealType>(
+            fromFixedPoint(fixedPointValues[i], getFixedPointShift(exponents[i])));
+      }
+      if (realCompensation != nullptr) {
+        realCompensation[i] = 0.;
+      }
+    }
+  }
+}
+
+}  // namespace CombiCom
+
+}  // namespace combigrid
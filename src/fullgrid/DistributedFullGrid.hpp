@@ -2,6 +2,7 @@
 #define DISTRIBUTEDCOMBIFULLGRID_HPP_
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cassert>
 #include <functional>
@@ -10,7 +11,9 @@
 #include <string>
 
 #include "fullgrid/FullGrid.hpp"
+#include "fullgrid/InterpolationPlan.hpp"
 #include "fullgrid/Tensor.hpp"
+#include "io/XdmfOutput.hpp"
 #include "mpi/MPICartesianUtils.hpp"
 #include "mpi/MPISystem.hpp"
 #include "mpi/MPITags.hpp"
@@ -25,6 +28,23 @@
 
 namespace combigrid {
 
+/**
+ * @brief copies the coordinates of numPoints points starting at first to structure-of-arrays
+ * layout, as used by DistributedFullGrid::evalLocalBatch: coordinate d of point i is written
+ * to coordinatesSoA[d * stride + i]
+ */
+static inline void getCoordinatesAsStructureOfArrays(
+    const std::vector<std::vector<real>>& coordinates, size_t first, size_t numPoints,
+    size_t stride, real* coordinatesSoA) {
+  assert(numPoints <= stride);
+  for (size_t i = 0; i < numPoints; ++i) {
+    const auto& point = coordinates[first + i];
+    for (size_t d = 0; d < point.size(); ++d) {
+      coordinatesSoA[d * stride + i] = point[d];
+    }
+  }
+}
+
 /* a regular (equidistant) domain decompositioning for an even number of processes
  * leads to grid points on the (geometrical) process boundaries.
  * with the forwardDecomposition flag it can be decided if the grid points on
@@ -256,6 +276,35 @@ void evalLocal(const std::vector<real>& coords, FG_ELEMENT& value) const {
   value = evalIndexAndAllUpperNeighbors(localIndexLowerNonzeroNeighborPoint, coords);
 }
 
+/** number of points evaluated together by evalLocalBatch */
+static constexpr size_t evalBatchSize = 256;
+
+/** evaluates the full grid on up to evalBatchSize points, like evalLocal for each point
+ * @param coordinates the coordinates as structure of arrays: coordinate d of point i is
+ * coordinates[d * stride + i], on the unit square [0,1]^D
+ * @param values [OUT] the values for all points, 0 if not on this process */
+void evalLocalBatch(const real* coordinates, size_t numPoints, size_t stride,
+                    FG_ELEMENT* values) const {
+  assert(numPoints <= evalBatchSize);
+  assert(numPoints <= stride);
+  switch (dim_) {
+    case 1:
+      return evalLocalBatch<1>(coordinates, numPoints, stride, values);
+    case 2:
+      return evalLocalBatch<2>(coordinates, numPoints, stride, values);
+    case 3:
+      return evalLocalBatch<3>(coordinates, numPoints, stride, values);
+    case 4:
+      return evalLocalBatch<4>(coordinates, numPoints, stride, values);
+    case 5:
+      return evalLocalBatch<5>(coordinates, numPoints, stride, values);
+    case 6:
+      return evalLocalBatch<6>(coordinates, numPoints, stride, values);
+    default:
+      return evalLocalBatch<0>(coordinates, numPoints, stride, values);
+  }
+}
+
 /** evaluates the full grid on the specified coordinates
  * @param interpolationCoords vector of ND coordinates on the unit square [0,1]^D*/
 std::vector<FG_ELEMENT> getInterpolatedValues(
@@ -263,11 +312,73 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
   auto numValues = interpolationCoords.size();
   std::vector<FG_ELEMENT> values;
   values.resize(numValues);
-#pragma omp parallel for default(none) firstprivate(numValues) shared(values, interpolationCoords) \
-    schedule(static)
-  for (size_t i = 0; i < numValues; ++i) {
-    this->evalLocal(interpolationCoords[i], values[i]);
+  const auto numBatches = (numValues + evalBatchSize - 1) / evalBatchSize;
+#pragma omp parallel default(none) firstprivate(numValues, numBatches) \
+    shared(values, interpolationCoords)
+  {
+    std::vector<real> batchCoordinates(dim_ * evalBatchSize);
+#pragma omp for schedule(static)
+    for (size_t batch = 0; batch < numBatches; ++batch) {
+      const auto first = batch * evalBatchSize;
+      const auto numPoints = std::min(evalBatchSize, numValues - first);
+      getCoordinatesAsStructureOfArrays(interpolationCoords, first, numPoints, evalBatchSize,
+                                        batchCoordinates.data());
+      this->evalLocalBatch(batchCoordinates.data(), numPoints, evalBatchSize,
+                           values.data() + first);
+    }
+  }
+  MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numValues), this->getMPIDatatype(),
+                MPI_SUM, this->getCommunicator());
+  return values;
+}
+
+/** builds the sparse interpolation matrix of this process' part of the grid on the specified
+ * coordinates, to repeatedly interpolate on the same coordinates as values change
+ * @param interpolationCoords vector of ND coordinates on the unit square [0,1]^D*/
+InterpolationPlan getInterpolationPlan(
+    const std::vector<std::vector<real>>& interpolationCoords) const {
+  const auto numValues = interpolationCoords.size();
+  InterpolationPlan plan(numValues);
+  std::vector<real> batchCoordinates(dim_ * evalBatchSize);
+  std::vector<IndexType> offsets(2 * dim_ * evalBatchSize);
+  std::vector<real> weights(2 * dim_ * evalBatchSize);
+  const size_t numCorners = combigrid::powerOfTwoByBitshift(dim_);
+  for (size_t first = 0; first < numValues; first += evalBatchSize) {
+    const auto numPoints = std::min(evalBatchSize, numValues - first);
+    getCoordinatesAsStructureOfArrays(interpolationCoords, first, numPoints, evalBatchSize,
+                                      batchCoordinates.data());
+    this->getBatchStencils(batchCoordinates.data(), numPoints, evalBatchSize, offsets.data(),
+                           weights.data());
+    // same corner order as evalLocalBatch, to get the same summation order
+    for (size_t i = 0; i < numPoints; ++i) {
+      bool isContributing = false;
+      for (size_t corner = 0; corner < numCorners; ++corner) {
+        IndexType index = 0;
+        real phi = 1.;
+        for (DimType d = 0; d < dim_; ++d) {
+          const size_t position = (2 * d + ((corner >> d) & 1)) * evalBatchSize + i;
+          index += offsets[position];
+          phi *= weights[position];
+        }
+        if (phi > 0.) {
+          if (!isContributing) {
+            plan.addPoint(first + i);
+            isContributing = true;
+          }
+          plan.addNeighbor(index, phi);
+        }
+      }
+    }
   }
+  return plan;
+}
+
+/** evaluates the full grid on the coordinates of an interpolation plan, cf. getInterpolationPlan
+ */
+std::vector<FG_ELEMENT> getInterpolatedValues(const InterpolationPlan& plan) const {
+  const auto numValues = plan.getNumCoordinates();
+  std::vector<FG_ELEMENT> values(numValues);
+  plan.apply(this->getData(), values.data());
   MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numValues), this->getMPIDatatype(),
                 MPI_SUM, this->getCommunicator());
   return values;
@@ -632,6 +743,25 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
     return r;
   }
 
+  /** returns the rank whose part of the grid contains the last grid point not above the
+   * coordinates in every dimension, such that every coordinate has exactly one owner
+   * @param coords ND coordinates on the unit square [0,1]^D */
+  RankType getRankOfCoordinates(const std::vector<real>& coords) const {
+    assert(coords.size() == dim_);
+    static thread_local std::vector<int> partitionCoords;
+    partitionCoords.resize(dim_);
+    for (DimType d = 0; d < dim_; ++d) {
+      const auto firstPointCoord = hasBoundaryPoints_[d] > 0 ? 0. : getGridSpacing()[d];
+      auto idx1d = static_cast<IndexType>(
+          std::floor((coords[d] - firstPointCoord) * this->getInverseGridSpacingIn(d)));
+      idx1d = std::max(IndexType(0), std::min(idx1d, this->getGlobalSizes()[d] - 1));
+      const auto& decomp1d = this->getDecomposition()[d];
+      auto lower = std::lower_bound(decomp1d.begin(), decomp1d.end(), idx1d + 1);
+      partitionCoords[d] = static_cast<int>(std::distance(decomp1d.begin(), lower)) - 1;
+    }
+    return this->getCartesianUtils().getRankFromPartitionCoords(partitionCoords);
+  }
+
   /** Number of Grids in every dimension*/
   inline const std::vector<int>& getParallelization() const {
     return this->getCartesianUtils().getCartesianDimensions();
@@ -1008,20 +1138,26 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
     } else {
       real p_f = static_cast<real>(p);
       auto data = this->getData();
+      const auto boundaryWeights = this->getLocal1dBoundaryWeights();
+      const auto& poleWeights = boundaryWeights[0];
+      const IndexType poleLength = this->getLocalSizes()[0];
+      const IndexType numPoles = poleLength == 0 ? 0 : this->getNrLocalElements() / poleLength;
       real res = 0.0;
 
-#pragma omp parallel for reduction(+ : res) default(none) shared(data, oneOverPowOfTwo) \
-    firstprivate(p_f) schedule(static)
-      for (size_t i = 0; i < this->getNrLocalElements(); ++i) {
-        auto isOnBoundary = this->isLocalLinearIndexOnBoundary(i);
-        auto countBoundary = std::count(isOnBoundary.begin(), isOnBoundary.end(), true);
-        double hatFcnIntegral = oneOverPowOfTwo[countBoundary];
-        // std::cout << hatFcnIntegral << std::endl;
-        // sumIntegral += hatFcnIntegral;
-        real abs = std::abs(data[i]);
-        res += std::pow(abs, p_f) * hatFcnIntegral;
+      // iterate the poles in dimension 0, the boundary weights of the other dimensions are
+      // constant along each pole
+#pragma omp parallel for reduction(+ : res) default(none) \
+    shared(data, boundaryWeights, poleWeights) firstprivate(p_f, poleLength, numPoles) \
+    schedule(static)
+      for (IndexType pole = 0; pole < numPoles; ++pole) {
+        const FG_ELEMENT* poleData = data + pole * poleLength;
+        real poleRes = 0.0;
+#pragma omp simd reduction(+ : poleRes)
+        for (IndexType i = 0; i < poleLength; ++i) {
+          poleRes += std::pow(std::abs(poleData[i]), p_f) * poleWeights[i];
+        }
+        res += poleRes * this->getPoleBoundaryWeight(pole, boundaryWeights);
       }
-      // std::cout << " sum " << sumIntegral << std::endl;
       real globalRes(0.);
       MPI_Allreduce(&res, &globalRes, 1, dtype, MPI_SUM, getCommunicator());
       // TODO this is only correct for 1 norm
@@ -1031,6 +1167,51 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
     }
   }
 
+  /**
+   * @brief Get the maximum, L1 and L2 norm of the data on the dfg in a single pass over the data
+   *        (cf. getLpNorm), with one reduction for the maximum and one for both sums
+   *
+   * @return std::array<real, 3> : the norms, indexed by p (0 being the maximum norm)
+   */
+  std::array<real, 3> getLpNorms() const {
+    MPI_Datatype dtype = abstraction::getMPIDatatype(abstraction::getabstractionDataType<real>());
+    auto data = this->getData();
+    const auto boundaryWeights = this->getLocal1dBoundaryWeights();
+    const auto& poleWeights = boundaryWeights[0];
+    const IndexType poleLength = this->getLocalSizes()[0];
+    const IndexType numPoles = poleLength == 0 ? 0 : this->getNrLocalElements() / poleLength;
+    real max = 0.0;
+    real sum1 = 0.0;
+    real sum2 = 0.0;
+
+#pragma omp parallel for reduction(max : max) reduction(+ : sum1, sum2) default(none) \
+    shared(data, boundaryWeights, poleWeights) firstprivate(poleLength, numPoles) schedule(static)
+    for (IndexType pole = 0; pole < numPoles; ++pole) {
+      const FG_ELEMENT* poleData = data + pole * poleLength;
+      real poleMax = 0.0;
+      real poleSum1 = 0.0;
+      real poleSum2 = 0.0;
+#pragma omp simd reduction(max : poleMax) reduction(+ : poleSum1, poleSum2)
+      for (IndexType i = 0; i < poleLength; ++i) {
+        const real abs = std::abs(poleData[i]);
+        poleMax = std::max(poleMax, abs);
+        poleSum1 += abs * poleWeights[i];
+        poleSum2 += abs * abs * poleWeights[i];
+      }
+      const real poleBoundaryWeight = this->getPoleBoundaryWeight(pole, boundaryWeights);
+      max = std::max(max, poleMax);
+      sum1 += poleSum1 * poleBoundaryWeight;
+      sum2 += poleSum2 * poleBoundaryWeight;
+    }
+    real globalMax(-1);
+    MPI_Allreduce(&max, &globalMax, 1, dtype, MPI_MAX, getCommunicator());
+    std::array<real, 2> sums = {sum1, sum2};
+    MPI_Allreduce(MPI_IN_PLACE, sums.data(), 2, dtype, MPI_SUM, getCommunicator());
+    const real innerNodalBasisFunctionIntegral = this->getInnerNodalBasisFunctionIntegral();
+    return {globalMax, sums[0] * innerNodalBasisFunctionIntegral,
+            std::sqrt(sums[1] * innerNodalBasisFunctionIntegral * innerNodalBasisFunctionIntegral)};
+  }
+
   // write data to file using MPI-IO
   void writePlotFile(const char* filename) const {
     auto dim = getDimension();
@@ -1096,6 +1277,31 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
     MPI_Type_free(&mysubarray);
   }
 
+  // read data from a file written by writePlotFile (with the same global sizes) using MPI-IO
+  void readPlotFile(const char* filename) {
+    auto [csizes, csubsizes, cstarts] = this->getSizesSubsizesStartsOfSubtensor();
+    MPI_Datatype mysubarray;
+    MPI_Type_create_subarray(static_cast<int>(getDimension()), &csizes[0], &csubsizes[0],
+                             &cstarts[0], MPI_ORDER_FORTRAN, getMPIDatatype(), &mysubarray);
+    MPI_Type_commit(&mysubarray);
+
+    MPI_File fh;
+    int err = MPI_File_open(getCommunicator(), filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+    if (err != MPI_SUCCESS) {
+      throw std::runtime_error("readPlotFile: could not open " + std::string(filename));
+    }
+    // skip the header that writePlotFile writes to non-.raw files
+    MPI_Offset offset = 0;
+    if (std::string(filename).find(".raw") == std::string::npos) {
+      offset = (1 + getDimension()) * sizeof(int);
+    }
+    MPI_File_set_view(fh, offset, getMPIDatatype(), mysubarray, "native", MPI_INFO_NULL);
+    MPI_File_read_all(fh, getData(), static_cast<int>(getNrLocalElements()), getMPIDatatype(),
+                      MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+    MPI_Type_free(&mysubarray);
+  }
+
   // write data to legacy-type VTK file using MPI-IO
   void writePlotFileVTK(const char* filename) const {
     auto dim = getDimension();
@@ -1170,6 +1376,45 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
     MPI_Type_free(&mysubarray);
   }
 
+  /**
+   * @brief write data to a raw binary file with MPI-IO, directly from each process's block, and
+   * describe it in an XDMF file (for visualization with e.g. ParaView); only up to 3D
+   *
+   * @param filenamePrefix the files filenamePrefix.bin and filenamePrefix.xdmf are written
+   */
+  void writeXdmfPlotFile(const std::string& filenamePrefix) const {
+    if (getDimension() > 3) {
+      throw std::runtime_error("writeXdmfPlotFile: XDMF output only supports up to 3D");
+    }
+    auto [csizes, csubsizes, cstarts] = this->getSizesSubsizesStartsOfSubtensor();
+    MPI_Datatype mysubarray;
+    MPI_Type_create_subarray(static_cast<int>(getDimension()), &csizes[0], &csubsizes[0],
+                             &cstarts[0], MPI_ORDER_FORTRAN, getMPIDatatype(), &mysubarray);
+    MPI_Type_commit(&mysubarray);
+
+    const std::string binaryFileName = filenamePrefix + ".bin";
+    MPI_File fh;
+    MPI_File_open(getCommunicator(), binaryFileName.c_str(), MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                  MPI_INFO_NULL, &fh);
+    MPI_File_set_size(fh, 0);
+    MPI_File_set_view(fh, 0, getMPIDatatype(), mysubarray, "native", MPI_INFO_NULL);
+    MPI_File_write_all(fh, getData(), static_cast<int>(getNrLocalElements()), getMPIDatatype(),
+                       MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+    MPI_Type_free(&mysubarray);
+
+    if (this->getRank() == 0) {
+      std::vector<real> origin(getDimension());
+      for (DimType d = 0; d < getDimension(); ++d) {
+        // grids without boundary points start at h
+        origin[d] = this->returnBoundaryFlags()[d] > 0 ? 0. : this->getGridSpacing()[d];
+      }
+      xdmfio::writeXdmfDescriptor<FG_ELEMENT>(filenamePrefix + ".xdmf",
+                                              xdmfio::getBaseName(binaryFileName),
+                                              this->getGlobalSizes(), origin, this->getGridSpacing());
+    }
+  }
+
   const std::vector<IndexVector>& getDecomposition() const { return decomposition_; }
 
   MPI_Datatype getUpwardSubarray(DimType d) {
@@ -1391,6 +1636,42 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
     return isGlobalLinearIndexOnBoundary(getGlobalLinearIndex(localLinearIndex));
   }
 
+  /**
+   * @brief the factor by which each local 1d index's basis function integral is scaled in each
+   *        dimension: 1/2 on the boundary points (cf. isGlobalLinearIndexOnBoundary), 1 otherwise
+   */
+  std::vector<std::vector<real>> getLocal1dBoundaryWeights() const {
+    std::vector<std::vector<real>> weights(this->getDimension());
+    for (DimType d = 0; d < this->getDimension(); ++d) {
+      weights[d].resize(this->getLocalSizes()[d], 1.);
+      if (this->returnBoundaryFlags()[d] == 2 && !weights[d].empty()) {
+        const auto firstGlobalIndex = this->getFirstGlobal1dIndex(d);
+        if (firstGlobalIndex == 0) {
+          weights[d].front() = 0.5;
+        }
+        if (firstGlobalIndex + this->getLocalSizes()[d] == this->length(d)) {
+          weights[d].back() = 0.5;
+        }
+      }
+    }
+    return weights;
+  }
+
+  /**
+   * @brief the product of the boundary weights in dimensions 1..D-1 for the pole (in dimension 0)
+   *        with linear index pole
+   */
+  inline real getPoleBoundaryWeight(IndexType pole,
+                                    const std::vector<std::vector<real>>& boundaryWeights) const {
+    real weight = 1.;
+    for (DimType d = 1; d < this->getDimension(); ++d) {
+      const auto localSize = this->getLocalSizes()[d];
+      weight *= boundaryWeights[d][pole % localSize];
+      pole /= localSize;
+    }
+    return weight;
+  }
+
   /**
    * @brief recursive helper function for getCornersGlobal*Indices
    *        (otherwise, it can't be dimension-independent)
@@ -1494,6 +1775,112 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
   std::vector<MPI_Datatype> downwardSubarrays_;
   std::vector<MPI_Datatype> upwardSubarrays_;
 
+  /**
+   * @brief the one-dimensional stencils of up to evalBatchSize points, for evalLocalBatch and
+   * getInterpolationPlan
+   *
+   * @param offsets [OUT] per dimension, lower / upper neighbor and point, the linear index offset
+   * of the neighbor point: offsets[(2 * d + isUpper) * evalBatchSize + i]; size 2 * dim_ *
+   * evalBatchSize
+   * @param weights [OUT] the hat function values of the neighbor points in the same layout, 0 if
+   * the neighbor is not on this process
+   */
+  void getBatchStencils(const real* coordinates, size_t numPoints, size_t stride,
+                        IndexType* offsets, real* weights) const {
+    const auto& h = this->getGridSpacing();
+    for (DimType d = 0; d < dim_; ++d) {
+      const real* coords = coordinates + d * stride;
+      IndexType* lowerOffsets = offsets + 2 * d * evalBatchSize;
+      IndexType* upperOffsets = lowerOffsets + evalBatchSize;
+      real* lowerWeights = weights + 2 * d * evalBatchSize;
+      real* upperWeights = lowerWeights + evalBatchSize;
+      const auto oneOverH = this->getInverseGridSpacingIn(d);
+      const auto lowerBoundCoord = this->getLowerBoundsCoord(d);
+      const auto lastIndex = this->getLocalSizes()[d] - 1;
+      const auto localOffset = this->getLocalOffsets()[d];
+      const auto firstPointNumber =
+          this->getLowerBounds()[d] + (hasBoundaryPoints_[d] > 0 ? 0 : 1);
+      const bool isPeriodicOnLowerBoundary =
+          this->hasBoundaryPoints_[d] == 1 &&
+          this->getCartesianUtils().isOnLowerBoundaryInDimension(d);
+      const auto globalSize = this->getGlobalSizes()[d];
+      for (size_t i = 0; i < numPoints; ++i) {
+        assert(coords[i] >= 0. && coords[i] <= 1.);
+        const auto lowerIndex =
+            static_cast<IndexType>(std::floor((coords[i] - lowerBoundCoord) * oneOverH));
+        // same conditions as in evalLocal / evalIndexAndAllUpperNeighbors
+        const bool isOnThisProcess =
+            lowerIndex >= -1 &&
+            (lowerIndex <= lastIndex || (coords[i] >= 1.0 - h[d] && isPeriodicOnLowerBoundary));
+        if (isOnThisProcess && lowerIndex >= 0 && lowerIndex <= lastIndex) {
+          lowerOffsets[i] = lowerIndex * localOffset;
+          lowerWeights[i] =
+              1. - std::abs(static_cast<double>(firstPointNumber + lowerIndex) * h[d] - coords[i]) *
+                       oneOverH;
+        } else {
+          lowerOffsets[i] = 0;
+          lowerWeights[i] = 0.;
+        }
+        const auto upperIndex = lowerIndex + 1;
+        if (isOnThisProcess && this->hasBoundaryPoints_[d] == 1 && upperIndex == globalSize) {
+          // periodic wrap-around to the first point
+          upperOffsets[i] = 0;
+          upperWeights[i] =
+              1. - std::abs(static_cast<double>(firstPointNumber) * h[d] - (coords[i] - 1.0)) *
+                       oneOverH;
+        } else if (isOnThisProcess && upperIndex <= lastIndex) {
+          upperOffsets[i] = upperIndex * localOffset;
+          upperWeights[i] =
+              1. - std::abs(static_cast<double>(firstPointNumber + upperIndex) * h[d] - coords[i]) *
+                       oneOverH;
+        } else {
+          upperOffsets[i] = 0;
+          upperWeights[i] = 0.;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief evalLocalBatch for dimensionality D (or any, if D is 0)
+   *
+   * For each dimension and point, the contributions of the lower and upper neighbor point are
+   * computed once (linear index offset and hat function value, 0 if not on this process);
+   * then the 2^D corners are summed up, vectorized over the points.
+   */
+  template <DimType D>
+  void evalLocalBatch(const real* coordinates, size_t numPoints, size_t stride,
+                      FG_ELEMENT* values) const {
+    const DimType dim = D == 0 ? dim_ : D;
+    static thread_local std::vector<IndexType> offsets;
+    static thread_local std::vector<real> weights;
+    offsets.resize(2 * dim * evalBatchSize);
+    weights.resize(2 * dim * evalBatchSize);
+    getBatchStencils(coordinates, numPoints, stride, offsets.data(), weights.data());
+
+    std::fill(values, values + numPoints, FG_ELEMENT(0.));
+    const FG_ELEMENT* data = this->getData();
+    const IndexType* offsetsData = offsets.data();
+    const real* weightsData = weights.data();
+    const size_t numCorners = combigrid::powerOfTwoByBitshift(dim);
+    for (size_t corner = 0; corner < numCorners; ++corner) {
+#pragma omp simd
+      for (size_t i = 0; i < numPoints; ++i) {
+        IndexType index = 0;
+        real phi = 1.;
+        for (DimType d = 0; d < dim; ++d) {
+          const size_t isUpper = (corner >> d) & 1;
+          const size_t position = (2 * d + isUpper) * evalBatchSize + i;
+          index += offsetsData[position];
+          phi *= weightsData[position];
+        }
+        if (phi > 0.) {
+          values[i] += phi * data[index];
+        }
+      }
+    }
+  }
+
   /**
    * @brief sets the MPI-related member cartesianUtils_
    *
@@ -1506,7 +1893,10 @@ std::vector<FG_ELEMENT> getInterpolatedValues(
     MPI_Topo_test(comm, &status);
 
     if (status == MPI_CART) {
-      if (comm != cartesianUtils_.getComm()) {
+      // a freed communicator's handle may be reused by MPI, so also re-read the topology
+      // if the cached one does not match
+      if (comm != cartesianUtils_.getComm() ||
+          procs != cartesianUtils_.getCartesianDimensions()) {
         assert(uniformDecomposition);
         cartesianUtils_ = MPICartesianUtils(comm);
       }
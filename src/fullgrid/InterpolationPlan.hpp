@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief the interpolation of a distributed full grid on a fixed set of coordinates, as a sparse
+ * matrix from this process' local grid values to the values at the coordinates
+ *
+ * only the coordinates this process contributes to are stored, each with the local linear
+ * indices and hat function values of its (up to 2^D) neighbor points in CSR layout, so that
+ * repeated interpolation only needs to stream through the grid values at these points;
+ * cf. DistributedFullGrid::getInterpolationPlan
+ */
+class InterpolationPlan {
+ public:
+  InterpolationPlan() : InterpolationPlan(0) {}
+
+  explicit InterpolationPlan(size_t numCoordinates)
+      : numCoordinates_(numCoordinates), rowStarts_(1, 0) {}
+
+  /** the number of coordinates the plan was built for */
+  inline size_t getNumCoordinates() const { return numCoordinates_; }
+
+  /** the indices of the coordinates this process contributes to, in ascending order */
+  inline const std::vector<size_t>& getPoints() const { return points_; }
+
+  /** the number of stored (local index, weight) pairs */
+  inline size_t getNumNonzeros() const { return weights_.size(); }
+
+  /** starts a new row for the coordinate with index coordinateIndex, cf. addNeighbor */
+  inline void addPoint(size_t coordinateIndex) {
+    assert(coordinateIndex < numCoordinates_);
+    assert(points_.empty() || points_.back() < coordinateIndex);
+    points_.push_back(coordinateIndex);
+    rowStarts_.push_back(rowStarts_.back());
+  }
+
+  /** adds a neighbor point to the last row */
+  inline void addNeighbor(IndexType localLinearIndex, real weight) {
+    assert(!points_.empty());
+    indices_.push_back(localLinearIndex);
+    weights_.push_back(weight);
+    ++rowStarts_.back();
+  }
+
+  /** the local contribution to the value at the k-th stored point (not the k-th coordinate) */
+  template <typename FG_ELEMENT>
+  inline FG_ELEMENT evalPoint(size_t k, const FG_ELEMENT* data) const {
+    FG_ELEMENT value = 0.;
+    for (size_t j = rowStarts_[k]; j < rowStarts_[k + 1]; ++j) {
+      value += weights_[j] * data[indices_[j]];
+    }
+    return value;
+  }
+
+  /**
+   * @brief evaluates the local contributions at all coordinates
+   *
+   * @param data the local grid values
+   * @param values [OUT] getNumCoordinates() values, 0 where this process does not contribute
+   */
+  template <typename FG_ELEMENT>
+  void apply(const FG_ELEMENT* data, FG_ELEMENT* values) const {
+    std::fill(values, values + numCoordinates_, FG_ELEMENT(0.));
+    const auto numPoints = points_.size();
+#pragma omp parallel for schedule(static)
+    for (size_t k = 0; k < numPoints; ++k) {
+      values[points_[k]] = evalPoint(k, data);
+    }
+  }
+
+ private:
+  size_t numCoordinates_;
+
+  /// the coordinate indices of the rows
+  std::vector<size_t> points_;
+
+  /// the first entry of each row in indices_ and weights_, and the end of the last row
+  std::vector<size_t> rowStarts_;
+
+  std::vector<IndexType> indices_;
+
+  std::vector<real> weights_;
+};
+
+}  // namespace combigrid
@@ -3,9 +3,11 @@
 
 #include "boost/lexical_cast.hpp"
 #include "fullgrid/DistributedFullGrid.hpp"
+#include "mpi/CommunicationCounters.hpp"
 #include "utils/IndexVector.hpp"
 #include "utils/PowerOfTwo.hpp"
 #include "utils/Stats.hpp"
+#include "utils/Tracing.hpp"
 
 namespace combigrid {
 
@@ -96,6 +98,7 @@ static void sendAndReceiveIndicesBlock(const std::map<RankType, std::set<IndexTy
                                        const DistributedFullGrid<FG_ELEMENT>& dfg, DimType dim,
                                        RemoteDataCollector<FG_ELEMENT>& remoteData) {
   assert(remoteData.empty());
+  TRACE_SCOPE(exchangeScope, "hierarchization exchange");
   // count elements of input indices
   auto numSend = send1dIndices.size();
   auto numRecv = recv1dIndices.size();
@@ -123,6 +126,7 @@ static void sendAndReceiveIndicesBlock(const std::map<RankType, std::set<IndexTy
 
   numSend = 0;
   numRecv = 0;
+  size_t numSlicesCommunicated = 0;
 // #pragma omp parallel shared(sendRequests, numSend, send1dIndices, recvRequests, numRecv, \
 //                                 remoteData, recv1dIndices, dfg, mysubarray)              \
 //     firstprivate(dfgStartAddr, dim) default(none)
@@ -175,6 +179,8 @@ static void sendAndReceiveIndicesBlock(const std::map<RankType, std::set<IndexTy
           sendIndex = numSend++;
           MPI_Isend(dfg.getData(), 1, myHBlock, dest, tag, dfg.getCommunicator(),
                     &sendRequests[sendIndex]);
+#pragma omp atomic
+          numSlicesCommunicated += indices.size();
         }
         MPI_Type_free(&myHBlock);
       }
@@ -228,6 +234,8 @@ static void sendAndReceiveIndicesBlock(const std::map<RankType, std::set<IndexTy
           recvIndex = numRecv++;
           MPI_Irecv(static_cast<void*>(bufs[0]), 1, myHBlock, src, tag, dfg.getCommunicator(),
                     &recvRequests[recvIndex]);
+#pragma omp atomic
+          numSlicesCommunicated += indices.size();
         }
         MPI_Type_free(&myHBlock);
       }
@@ -237,10 +245,19 @@ static void sendAndReceiveIndicesBlock(const std::map<RankType, std::set<IndexTy
   // free after parallel region
   MPI_Type_free(&mysubarray);
 
+  const uint64_t bytesCommunicated = numSlicesCommunicated *
+                                     (dfg.getNrLocalElements() / dfg.getLocalSizes()[dim]) *
+                                     sizeof(FG_ELEMENT);
+  exchangeScope.addBytes(bytesCommunicated);
+
   assert(sendRequests.size() == numSend);
   assert(recvRequests.size() == numRecv);
-  MPI_Waitall(static_cast<int>(sendRequests.size()), sendRequests.data(), MPI_STATUSES_IGNORE);
-  MPI_Waitall(static_cast<int>(recvRequests.size()), recvRequests.data(), MPI_STATUSES_IGNORE);
+  {
+    CommunicationCounters::WaitTimer waitTimer(dfg.getCommunicator(), numSend + numRecv,
+                                               bytesCommunicated);
+    MPI_Waitall(static_cast<int>(sendRequests.size()), sendRequests.data(), MPI_STATUSES_IGNORE);
+    MPI_Waitall(static_cast<int>(recvRequests.size()), recvRequests.data(), MPI_STATUSES_IGNORE);
+  }
 }
 
 /**
@@ -1126,9 +1143,11 @@ class DistributedHierarchization {
     assert(dfg.getDimension() > 0);
     assert(dfg.getDimension() == dims.size());
     assert(!lmin.empty());
+    CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::hierarchization);
     // exchange data
     for (DimType dim = 0; dim < dfg.getDimension(); ++dim) {
       if (!dims[dim]) continue;
+      TRACE_SCOPE(dimensionScope, "hierarchize dimension");
       RemoteDataCollector<FG_ELEMENT> remoteData;
       if (dynamic_cast<HierarchicalHatBasisFunction*>(hierarchicalBases[dim]) != nullptr ||
           dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(hierarchicalBases[dim]) != nullptr) {
@@ -1207,8 +1226,10 @@ class DistributedHierarchization {
     assert(!lmin.empty());
     assert(dfg.getDimension() > 0);
     assert(dfg.getDimension() == dims.size());
+    CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::dehierarchization);
     for (DimType dim = 0; dim < dfg.getDimension(); ++dim) {
       if (!dims[dim]) continue;
+      TRACE_SCOPE(dimensionScope, "dehierarchize dimension");
       RemoteDataCollector<FG_ELEMENT> remoteData;
       if (dynamic_cast<HierarchicalHatBasisFunction*>(hierarchicalBases[dim]) != nullptr ||
           dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(hierarchicalBases[dim]) != nullptr) {
@@ -5,7 +5,12 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <cassert>
+#include <iostream>
 #include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "utils/Types.hpp"
 
@@ -224,5 +229,70 @@ int readReduceValuesConsecutive(T* valuesStart, MPI_Offset numValues, const std:
   MPI_Info_free(&info);
   return readcount;
 }
+
+/**
+ * @brief reads this process's consecutive part of several files of the same layout in chunks of
+ * at most numElementsToBuffer values per file, and passes each chunk to processChunk
+ *
+ * only the chunk buffers are held in memory; all processes take part in the same number of
+ * collective reads, also if their parts are of different size
+ *
+ * @param processChunk called as processChunk(firstValueIndex, numValuesInChunk, buffers), where
+ * buffers[f] holds the chunk read from fileNames[f]
+ * @return the number of values read per file
+ */
+template <typename T, typename ChunkFunctionType>
+MPI_Offset readValuesConsecutiveChunked(MPI_Offset numValues,
+                                        const std::vector<std::string>& fileNames,
+                                        combigrid::CommunicatorType comm, int numElementsToBuffer,
+                                        ChunkFunctionType processChunk,
+                                        bool withCollectiveBuffering = false) {
+  assert(numElementsToBuffer > 0);
+  MPI_Offset pos = 0;
+  MPI_Exscan(&numValues, &pos, 1, MPI_OFFSET, MPI_SUM, comm);
+  MPI_Offset numChunks = (numValues + numElementsToBuffer - 1) / numElementsToBuffer;
+  MPI_Allreduce(MPI_IN_PLACE, &numChunks, 1, MPI_OFFSET, MPI_MAX, comm);
+
+  MPI_Info info = getNewConsecutiveMpiInfo(withCollectiveBuffering);
+  MPI_Info_set(info, "access_style", "read_once,sequential");
+  std::vector<MPI_File> fileHandles(fileNames.size());
+  for (size_t f = 0; f < fileNames.size(); ++f) {
+    int err = MPI_File_open(comm, fileNames[f].c_str(), MPI_MODE_RDONLY, info, &fileHandles[f]);
+    if (err != MPI_SUCCESS) {
+      throw std::runtime_error("read: could not open! " + fileNames[f] + ": " +
+                               getMpiErrorString(err));
+    }
+    checkFileSizeConsecutive<T>(fileHandles[f], numValues, comm);
+  }
+
+  MPI_Datatype dataType = getMPIDatatype(abstraction::getabstractionDataType<T>());
+  std::vector<std::vector<T>> buffers(
+      fileNames.size(), std::vector<T>(std::min(static_cast<MPI_Offset>(numElementsToBuffer),
+                                                numValues)));
+  MPI_Offset readcount = 0;
+  for (MPI_Offset chunk = 0; chunk < numChunks; ++chunk) {
+    // processes that are done take part in the collective reads with zero values
+    const auto numToRead = static_cast<int>(
+        std::min(static_cast<MPI_Offset>(numElementsToBuffer), numValues - readcount));
+    for (size_t f = 0; f < fileNames.size(); ++f) {
+      MPI_Status status;
+      int err = MPI_File_read_at_all(fileHandles[f], (pos + readcount) * sizeof(T),
+                                     buffers[f].data(), numToRead, dataType, &status);
+      if (err != MPI_SUCCESS) {
+        throw std::runtime_error("read: error in MPI_File_read_at_all " + fileNames[f] + ": " +
+                                 getMpiErrorString(err));
+      }
+    }
+    if (numToRead > 0) {
+      processChunk(readcount, numToRead, buffers);
+    }
+    readcount += numToRead;
+  }
+  for (auto& fh : fileHandles) {
+    MPI_File_close(&fh);
+  }
+  MPI_Info_free(&info);
+  return readcount;
+}
 }  // namespace mpiio
 }  // namespace combigrid
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "utils/Types.hpp"
+
+namespace combigrid {
+namespace xdmfio {
+
+/**
+ * @brief writes an XDMF descriptor for a raw binary file that contains the values of a uniform
+ * (Co-Rectilinear) grid of up to three dimensions, such that ParaView / VisIt can read it
+ *
+ * only needs to be called by a single process; the binary file is written separately, e.g. by all
+ * processes through MPI-IO
+ *
+ * @param xdmfFileName the name of the descriptor to write
+ * @param binaryFileName the name of the binary file, relative to the descriptor
+ * @param extents the number of points per dimension, the first dimension varies fastest in the
+ * binary file
+ * @param origin the coordinates of the first point
+ * @param spacing the distance between neighboring points in each dimension
+ */
+template <typename T>
+void writeXdmfDescriptor(const std::string& xdmfFileName, const std::string& binaryFileName,
+                         const IndexVector& extents, const std::vector<real>& origin,
+                         const std::vector<real>& spacing) {
+  if (extents.empty() || extents.size() > 3) {
+    throw std::runtime_error("XDMF output only supports 1 to 3 dimensions");
+  }
+  assert(origin.size() == extents.size() && spacing.size() == extents.size());
+  constexpr bool isComplex = !std::is_arithmetic<T>::value;
+  using RealType = typename std::conditional<isComplex, real, T>::type;
+  static_assert(!isComplex || sizeof(T) == 2 * sizeof(real), "only complex<real> is supported");
+  static_assert(std::is_floating_point<RealType>::value, "only floating point output supported");
+
+  // XDMF lists the dimensions slowest first; 1D grids are written as a 2D grid of height 1
+  const auto numDims = std::max(extents.size(), static_cast<size_t>(2));
+  std::string dimensions;
+  std::stringstream originStream;
+  std::stringstream spacingStream;
+  originStream.precision(std::numeric_limits<real>::max_digits10);
+  spacingStream.precision(std::numeric_limits<real>::max_digits10);
+  for (size_t i = 0; i < numDims; ++i) {
+    const auto d = numDims - 1 - i;
+    const bool isPadding = d >= extents.size();
+    dimensions += std::to_string(isPadding ? 1 : extents[d]) + " ";
+    originStream << (isPadding ? 0. : origin[d]) << " ";
+    spacingStream << (isPadding ? 1. : spacing[d]) << " ";
+  }
+  dimensions.pop_back();
+  const std::string topologyType = numDims == 2 ? "2DCoRectMesh" : "3DCoRectMesh";
+  const std::string geometryType = numDims == 2 ? "ORIGIN_DXDY" : "ORIGIN_DXDYDZ";
+  const std::string endian =
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+      "Big";
+#else
+      "Little";
+#endif
+  const std::string numberType = "NumberType=\"Float\" Precision=\"" +
+                                 std::to_string(sizeof(RealType)) + "\" Endian=\"" + endian +
+                                 "\" Format=\"Binary\"";
+
+  std::ofstream ofs(xdmfFileName);
+  ofs << "<?xml version=\"1.0\" ?>\n"
+      << "<Xdmf Version=\"2.0\">\n"
+      << " <Domain>\n"
+      << "  <Grid Name=\"combination\" GridType=\"Uniform\">\n"
+      << "   <Topology TopologyType=\"" << topologyType << "\" Dimensions=\"" << dimensions
+      << "\"/>\n"
+      << "   <Geometry GeometryType=\"" << geometryType << "\">\n"
+      << "    <DataItem Dimensions=\"" << numDims << "\" Format=\"XML\">" << originStream.str()
+      << "</DataItem>\n"
+      << "    <DataItem Dimensions=\"" << numDims << "\" Format=\"XML\">" << spacingStream.str()
+      << "</DataItem>\n"
+      << "   </Geometry>\n";
+  if (!isComplex) {
+    ofs << "   <Attribute Name=\"values\" AttributeType=\"Scalar\" Center=\"Node\">\n"
+        << "    <DataItem Dimensions=\"" << dimensions << "\" " << numberType << ">"
+        << binaryFileName << "</DataItem>\n"
+        << "   </Attribute>\n";
+  } else {
+    // real and imaginary part are interleaved, select them as hyperslabs in the component index
+    std::string startString;
+    std::string strideString;
+    for (size_t i = 0; i < numDims; ++i) {
+      startString += "0 ";
+      strideString += "1 ";
+    }
+    const std::vector<std::string> parts = {"real", "imag"};
+    for (size_t part = 0; part < parts.size(); ++part) {
+      ofs << "   <Attribute Name=\"" << parts[part]
+          << "\" AttributeType=\"Scalar\" Center=\"Node\">\n"
+          << "    <DataItem ItemType=\"HyperSlab\" Dimensions=\"" << dimensions << " 1\">\n"
+          << "     <DataItem Dimensions=\"3 " << numDims + 1 << "\" Format=\"XML\">"
+          << startString << part << " " << strideString << "1 " << dimensions << " 1"
+          << "</DataItem>\n"
+          << "     <DataItem Dimensions=\"" << dimensions << " 2\" " << numberType << ">"
+          << binaryFileName << "</DataItem>\n"
+          << "    </DataItem>\n"
+          << "   </Attribute>\n";
+    }
+  }
+  ofs << "  </Grid>\n"
+      << " </Domain>\n"
+      << "</Xdmf>\n";
+}
+
+/**
+ * @brief the file name without any leading directories, for references between files in the
+ * same directory
+ */
+static inline std::string getBaseName(const std::string& fileName) {
+  const auto pos = fileName.find_last_of('/');
+  return pos == std::string::npos ? fileName : fileName.substr(pos + 1);
+}
+
+}  // namespace xdmfio
+}  // namespace combigrid
@@ -275,6 +275,22 @@ class CombiParameters {
     return sizeForChunkedCommunicationInMebibyte_;
   }
 
+  inline void setCombinationVariant(CombinationVariant combinationVariant) {
+    combinationVariant_ = combinationVariant;
+  }
+
+  inline void setChunkSizeInMebibybtePerThread(uint32_t sizeForChunkedCommunicationInMebibyte) {
+    sizeForChunkedCommunicationInMebibyte_ = sizeForChunkedCommunicationInMebibyte;
+  }
+
+  /* whether the reduction between process groups is bitwise reproducible, at the cost of more
+   * communication, cf. CombiCom::reproducibleReduce */
+  inline bool isReduceReproducible() const { return reproducibleReduce_; }
+
+  inline void setReduceReproducible(bool reproducibleReduce) {
+    reproducibleReduce_ = reproducibleReduce;
+  }
+
   inline const std::string& getThirdLevelHost() { return thirdLevelHost_; }
 
   inline unsigned short getThirdLevelPort() {
@@ -364,6 +380,8 @@ class CombiParameters {
 
   uint32_t sizeForChunkedCommunicationInMebibyte_;
 
+  bool reproducibleReduce_ = false;
+
   /**
    * This level vector indicates which dimension of lmin should be decreased by how many levels
    * for constructing the distributed sparse grid.
@@ -414,6 +432,7 @@ void CombiParameters::serialize(Archive& ar, const unsigned int version) {
   ar& numGridsPerTask_;
   ar& combinationVariant_;
   ar& sizeForChunkedCommunicationInMebibyte_;
+  ar& reproducibleReduce_;
   ar& reduceCombinationDimsLmin_;
   ar& reduceCombinationDimsLmax_;
   ar& thirdLevelHost_;
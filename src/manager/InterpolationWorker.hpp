@@ -1,4 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "fullgrid/InterpolationPlan.hpp"
 #include "io/H5InputOutput.hpp"
 #include "manager/TaskWorker.hpp"
 #include "mpi/MPISystem.hpp"
@@ -7,23 +14,249 @@
 
 namespace combigrid {
 
+/**
+ * @brief the interpolation plans of all tasks for one set of coordinates, such that repeated
+ * interpolation on the same coordinates (e.g. after every combination) only applies them
+ *
+ * the plans are rebuilt if the coordinates change, and built for new tasks as they appear.
+ * Optionally, every coordinate is assigned to an owner rank in the process group, to which the
+ * other ranks of the group send their contributions, cf. reduceByOwnership
+ */
+class InterpolationPlanCache {
+ public:
+  /**
+   * @brief makes sure there are plans for all tasks on interpolationCoords
+   *
+   * if an ownershipGrid is given, every coordinate is owned by the rank whose part of the
+   * ownershipGrid contains it; the ownershipGrid needs to be partitioned the same in all process
+   * groups. Collective on the local communicator if the coordinates or tasks changed.
+   */
+  void update(const std::vector<std::unique_ptr<Task>>& tasks,
+              const std::vector<std::vector<real>>& interpolationCoords,
+              const DistributedFullGrid<CombiDataType>* ownershipGrid = nullptr) {
+    bool hasChanged = false;
+    if (interpolationCoords != coordinates_) {
+      coordinates_ = interpolationCoords;
+      plans_.clear();
+      hasChanged = true;
+    }
+    // drop the plans of tasks that are not here any more
+    for (auto it = plans_.begin(); it != plans_.end();) {
+      const bool isPresent = std::any_of(tasks.begin(), tasks.end(), [&it](const auto& task) {
+        return task->getID() == it->first;
+      });
+      hasChanged |= !isPresent;
+      it = isPresent ? std::next(it) : plans_.erase(it);
+    }
+    for (const auto& task : tasks) {
+      if (plans_.find(task->getID()) == plans_.end()) {
+        plans_[task->getID()] =
+            task->getDistributedFullGrid().getInterpolationPlan(interpolationCoords);
+        hasChanged = true;
+      }
+    }
+    if (ownershipGrid != nullptr && (hasChanged || !hasOwnership_)) {
+      updateOwnership(*ownershipGrid);
+    }
+  }
+
+  /** the plan of a task, cf. update */
+  const InterpolationPlan& getPlan(const Task& task) const { return plans_.at(task.getID()); }
+
+  /**
+   * @brief sums up the contributions of all processes of all process groups to the values at the
+   * coordinates, cf. update with ownershipGrid
+   *
+   * each process sends the values it contributes to to the points' owners in its process group,
+   * and only the owned values are reduced across the process groups, instead of reducing the
+   * values at all coordinates twice
+   *
+   * @param values [IN/OUT] this process' contributions at all coordinates; the sum on all
+   * processes, or only on the master of the last process group if onlyOutputMaster (empty
+   * everywhere else)
+   */
+  template <typename CombinableType>
+  void reduceByOwnership(std::vector<CombinableType>& values, bool onlyOutputMaster) const {
+    assert(hasOwnership_);
+    assert(values.size() == coordinates_.size());
+    const auto dataType =
+        abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombinableType>());
+    const auto& localComm = theMPISystem()->getLocalComm();
+    const auto numOwned = pointsPerOwner_[theMPISystem()->getLocalRank()];
+
+    // send the contributions to the owners within the process group
+    std::vector<CombinableType> sendValues(sendPoints_.size());
+    for (size_t j = 0; j < sendPoints_.size(); ++j) {
+      sendValues[j] = values[sendPoints_[j]];
+    }
+    std::vector<CombinableType> receiveValues(receivePositions_.size());
+    MPI_Alltoallv(sendValues.data(), sendCounts_.data(), sendDisplacements_.data(), dataType,
+                  receiveValues.data(), receiveCounts_.data(), receiveDisplacements_.data(),
+                  dataType, localComm);
+    std::vector<CombinableType> ownedValues(numOwned, 0.);
+    for (size_t j = 0; j < receivePositions_.size(); ++j) {
+      ownedValues[receivePositions_[j]] += receiveValues[j];
+    }
+
+    // the same rank in every process group owns the same points
+    // TODO is it necessary to correct for the kahan terms across process groups too?
+    if (onlyOutputMaster) {
+      const RankType outputGroup = static_cast<RankType>(theMPISystem()->getNumGroups() - 1);
+      const bool isOutputGroup = theMPISystem()->getProcessGroupNumber() == outputGroup;
+      MPI_Reduce(isOutputGroup ? MPI_IN_PLACE : ownedValues.data(), ownedValues.data(), numOwned,
+                 dataType, MPI_SUM, outputGroup, theMPISystem()->getGlobalReduceComm());
+      std::vector<CombinableType> gatheredValues;
+      if (isOutputGroup) {
+        MASTER_EXCLUSIVE_SECTION { gatheredValues.resize(values.size()); }
+        MPI_Gatherv(ownedValues.data(), numOwned, dataType, gatheredValues.data(),
+                    pointsPerOwner_.data(), ownerDisplacements_.data(), dataType,
+                    theMPISystem()->getMasterRank(), localComm);
+      }
+      values.clear();
+      if (!gatheredValues.empty()) {
+        values.resize(gatheredValues.size());
+        for (size_t j = 0; j < pointsByOwner_.size(); ++j) {
+          values[pointsByOwner_[j]] = gatheredValues[j];
+        }
+      }
+    } else {
+      MPI_Allreduce(MPI_IN_PLACE, ownedValues.data(), numOwned, dataType, MPI_SUM,
+                    theMPISystem()->getGlobalReduceComm());
+      std::vector<CombinableType> gatheredValues(values.size());
+      MPI_Allgatherv(ownedValues.data(), numOwned, dataType, gatheredValues.data(),
+                     pointsPerOwner_.data(), ownerDisplacements_.data(), dataType, localComm);
+      for (size_t j = 0; j < pointsByOwner_.size(); ++j) {
+        values[pointsByOwner_[j]] = gatheredValues[j];
+      }
+    }
+  }
+
+ private:
+  void updateOwnership(const DistributedFullGrid<CombiDataType>& ownershipGrid) {
+    const auto numProcs = static_cast<size_t>(theMPISystem()->getNumProcs());
+    assert(ownershipGrid.getCommunicatorSize() == static_cast<int>(numProcs));
+    const auto numCoordinates = coordinates_.size();
+    std::vector<RankType> owners(numCoordinates);
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < numCoordinates; ++i) {
+      owners[i] = ownershipGrid.getRankOfCoordinates(coordinates_[i]);
+    }
+    // all points, grouped by owner
+    std::vector<size_t> allPoints(numCoordinates);
+    std::iota(allPoints.begin(), allPoints.end(), 0);
+    groupByOwner(owners, numProcs, allPoints, pointsByOwner_, pointsPerOwner_,
+                 ownerDisplacements_);
+
+    // the points this process contributes to, grouped by owner
+    std::vector<size_t> contributingPoints;
+    for (const auto& plan : plans_) {
+      contributingPoints.insert(contributingPoints.end(), plan.second.getPoints().begin(),
+                                plan.second.getPoints().end());
+    }
+    std::sort(contributingPoints.begin(), contributingPoints.end());
+    contributingPoints.erase(std::unique(contributingPoints.begin(), contributingPoints.end()),
+                             contributingPoints.end());
+    groupByOwner(owners, numProcs, contributingPoints, sendPoints_, sendCounts_,
+                 sendDisplacements_);
+
+    // tell the owners which points they will receive
+    const auto& localComm = theMPISystem()->getLocalComm();
+    receiveCounts_.resize(numProcs);
+    MPI_Alltoall(sendCounts_.data(), 1, MPI_INT, receiveCounts_.data(), 1, MPI_INT, localComm);
+    receiveDisplacements_.resize(numProcs);
+    std::exclusive_scan(receiveCounts_.begin(), receiveCounts_.end(),
+                        receiveDisplacements_.begin(), 0);
+    std::vector<size_t> receivePoints(receiveDisplacements_.back() + receiveCounts_.back());
+    const auto indexType = abstraction::getMPIDatatype(abstraction::getabstractionDataType<size_t>());
+    MPI_Alltoallv(sendPoints_.data(), sendCounts_.data(), sendDisplacements_.data(), indexType,
+                  receivePoints.data(), receiveCounts_.data(), receiveDisplacements_.data(),
+                  indexType, localComm);
+    const auto rank = theMPISystem()->getLocalRank();
+    const auto ownedBegin = pointsByOwner_.begin() + ownerDisplacements_[rank];
+    const auto ownedEnd = ownedBegin + pointsPerOwner_[rank];
+    receivePositions_.resize(receivePoints.size());
+    for (size_t j = 0; j < receivePoints.size(); ++j) {
+      const auto position = std::lower_bound(ownedBegin, ownedEnd, receivePoints[j]);
+      assert(position != ownedEnd && *position == receivePoints[j]);
+      receivePositions_[j] = static_cast<size_t>(std::distance(ownedBegin, position));
+    }
+    hasOwnership_ = true;
+  }
+
+  /** sorts the points by owner, keeping their order per owner */
+  static void groupByOwner(const std::vector<RankType>& owners, size_t numProcs,
+                           const std::vector<size_t>& points, std::vector<size_t>& grouped,
+                           std::vector<int>& counts, std::vector<int>& displacements) {
+    counts.assign(numProcs, 0);
+    for (const auto& point : points) {
+      ++counts[owners[point]];
+    }
+    displacements.resize(numProcs);
+    std::exclusive_scan(counts.begin(), counts.end(), displacements.begin(), 0);
+    auto nextPosition = displacements;
+    grouped.resize(points.size());
+    for (const auto& point : points) {
+      grouped[nextPosition[owners[point]]++] = point;
+    }
+  }
+
+  std::vector<std::vector<real>> coordinates_;
+
+  std::map<size_t, InterpolationPlan> plans_;
+
+  bool hasOwnership_ = false;
+
+  /// all coordinate indices, grouped by owner rank, and the number of points per owner
+  std::vector<size_t> pointsByOwner_;
+  std::vector<int> pointsPerOwner_;
+  std::vector<int> ownerDisplacements_;
+
+  /// the coordinate indices this process contributes to, grouped by owner rank
+  std::vector<size_t> sendPoints_;
+  std::vector<int> sendCounts_;
+  std::vector<int> sendDisplacements_;
+
+  /// for each received contribution, the position among the points owned by this process
+  std::vector<size_t> receivePositions_;
+  std::vector<int> receiveCounts_;
+  std::vector<int> receiveDisplacements_;
+};
+
+/**
+ * @brief interpolates the combined solution of all tasks in all process groups at the
+ * coordinates
+ *
+ * with an ownershipGrid, the values are reduced by ownership (cf.
+ * InterpolationPlanCache::reduceByOwnership); otherwise, they are all-reduced in the process group
+ * and across process groups
+ *
+ * @param onlyOutputMaster if true (and there is an ownershipGrid), the values are only returned
+ * on the master of the last process group, and are empty everywhere else
+ */
 template <typename CombinableType>
 static std::vector<CombinableType> interpolateValues(
-    const std::vector<std::unique_ptr<Task>>& tasks,
-    const std::vector<std::vector<real>>& interpolationCoords) {
+    const std::vector<std::unique_ptr<Task>>& tasks, InterpolationPlanCache& plans,
+    const std::vector<std::vector<real>>& interpolationCoords,
+    const DistributedFullGrid<CombiDataType>* ownershipGrid = nullptr,
+    bool onlyOutputMaster = false) {
+  plans.update(tasks, interpolationCoords, ownershipGrid);
   auto numCoordinates = interpolationCoords.size();
 
-  // call interpolation function on tasks and reduce with combination coefficient
+  // apply interpolation plans of the tasks and reduce with combination coefficient;
+  // each process only touches the points it contributes to
   std::vector<CombinableType> values(numCoordinates, 0.);
   std::vector<CombinableType> kahanTrailingTerm(numCoordinates, 0.);
-
   for (const auto& task : tasks) {
     const auto coeff = task->getCoefficient();
-#pragma omp parallel for default(none) firstprivate(numCoordinates, coeff) \
-    shared(values, kahanTrailingTerm, interpolationCoords, task) schedule(dynamic)
-    for (size_t i = 0; i < numCoordinates; ++i) {
-      auto localValue = task->getDistributedFullGrid().evalLocal(interpolationCoords[i]);
-      auto summand = localValue * coeff;
+    const auto& plan = plans.getPlan(*task);
+    const auto& points = plan.getPoints();
+    const auto numPoints = points.size();
+    const CombiDataType* data = task->getDistributedFullGrid().getData();
+#pragma omp parallel for schedule(static) default(none) \
+    firstprivate(numPoints, coeff, data) shared(plan, points, values, kahanTrailingTerm)
+    for (size_t k = 0; k < numPoints; ++k) {
+      const auto i = points[k];
+      auto summand = plan.evalPoint(k, data) * coeff;
       // cf. https://en.wikipedia.org/wiki/Kahan_summation_algorithm
       auto y = summand - kahanTrailingTerm[i];
       auto t = values[i] + y;
@@ -31,6 +264,11 @@ static std::vector<CombinableType> interpolateValues(
       values[i] = t;
     }
   }
+  if (ownershipGrid != nullptr) {
+    plans.reduceByOwnership(values, onlyOutputMaster);
+    return values;
+  }
+
   // reduce interpolated values within process group
   MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numCoordinates),
                 abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombinableType>()),
@@ -47,13 +285,24 @@ static std::vector<CombinableType> interpolateValues(
   return values;
 }
 
-static void writeInterpolatedValuesPerGrid(
+/** interpolateValues with plans that are only used once */
+template <typename CombinableType>
+static std::vector<CombinableType> interpolateValues(
     const std::vector<std::unique_ptr<Task>>& tasks,
+    const std::vector<std::vector<real>>& interpolationCoords) {
+  InterpolationPlanCache plans;
+  return interpolateValues<CombinableType>(tasks, plans, interpolationCoords);
+}
+
+static void writeInterpolatedValuesPerGrid(
+    const std::vector<std::unique_ptr<Task>>& tasks, InterpolationPlanCache& plans,
     const std::vector<std::vector<real>>& interpolationCoords, const std::string& fileNamePrefix,
     IndexType currentCombinationStep) {
+  plans.update(tasks, interpolationCoords);
   // call interpolation function on tasks and write out task-wise
   for (size_t i = 0; i < tasks.size(); ++i) {
-    auto taskVals = tasks[i]->getDistributedFullGrid().getInterpolatedValues(interpolationCoords);
+    auto taskVals = tasks[i]->getDistributedFullGrid().getInterpolatedValues(
+        plans.getPlan(*tasks[i]));
     // cycle through ranks to write
     if (i % (theMPISystem()->getNumProcs()) == theMPISystem()->getLocalRank()) {
       std::string saveFilePath =
@@ -68,11 +317,13 @@ static void writeInterpolatedValuesPerGrid(
 
 template <typename CombinableType>
 static void writeInterpolatedValuesSingleFile(
-    const std::vector<std::unique_ptr<Task>>& tasks,
+    const std::vector<std::unique_ptr<Task>>& tasks, InterpolationPlanCache& plans,
     const std::vector<std::vector<real>>& interpolationCoords, const std::string& filenamePrefix,
-    IndexType currentCombinationStep) {
+    IndexType currentCombinationStep,
+    const DistributedFullGrid<CombiDataType>* ownershipGrid = nullptr) {
   // all processes interpolate
-  auto values = interpolateValues<CombinableType>(tasks, interpolationCoords);
+  auto values = interpolateValues<CombinableType>(tasks, plans, interpolationCoords,
+                                                  ownershipGrid, true);
   // one process writes
   OTHER_OUTPUT_GROUP_EXCLUSIVE_SECTION {
     MASTER_EXCLUSIVE_SECTION {
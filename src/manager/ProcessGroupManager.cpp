@@ -639,6 +639,24 @@ void ProcessGroupManager::getLpNorms(int p, std::map<size_t, double>& norms) {
   this->setProcessGroupBusyAndReceive();
 }
 
+void ProcessGroupManager::getAllLpNorms(std::map<size_t, std::array<double, 3>>& norms) {
+  this->sendSignalToProcessGroup(GET_ALL_LP_NORMS);
+
+  std::vector<double> recvbuf;
+  auto numTasks = this->getTaskContainer().size();
+  recvbuf.resize(3 * numTasks);
+
+  MPI_Recv(recvbuf.data(), static_cast<int>(recvbuf.size()), MPI_DOUBLE, pgroupRootID_,
+           TRANSFER_NORM_TAG, theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
+
+  for (size_t j = 0; j < numTasks; ++j) {
+    auto& taskNorms = norms[this->getTaskContainer()[j]->getID()];
+    std::copy(recvbuf.begin() + 3 * j, recvbuf.begin() + 3 * (j + 1), taskNorms.begin());
+  }
+
+  this->setProcessGroupBusyAndReceive();
+}
+
 std::vector<double> ProcessGroupManager::evalAnalyticalOnDFG(const LevelVector& leval) {
   sendSignalToProcessGroup(EVAL_ANALYTICAL_NORM);
   sendLevelVector(leval, pgroupRootID_);
@@ -694,6 +712,43 @@ void ProcessGroupManager::interpolateValues(const std::vector<real>& interpolati
   setProcessGroupBusyAndReceive();
 }
 
+void ProcessGroupManager::interpolateValuesOnSparseGrid(
+    const std::vector<real>& interpolationCoordsSerial, std::vector<CombiDataType>& values,
+    MPI_Request* request) {
+  assert(interpolationCoordsSerial.size() < static_cast<size_t>(std::numeric_limits<int>::max()) &&
+         "needs chunking!");
+  assert(request != nullptr && !values.empty());
+  sendSignalToProcessGroup(INTERPOLATE_VALUES_ON_SPARSE_GRID_AND_SEND_BACK);
+  MPI_Request dummyRequest;
+  // send interpolation coordinates to group
+  MPI_Isend(interpolationCoordsSerial.data(), static_cast<int>(interpolationCoordsSerial.size()),
+            abstraction::getMPIDatatype(abstraction::getabstractionDataType<real>()), pgroupRootID_,
+            TRANSFER_INTERPOLATION_TAG, theMPISystem()->getGlobalComm(), &dummyRequest);
+  MPI_Request_free(&dummyRequest);
+  MPI_Irecv(values.data(), static_cast<int>(values.size()),
+            abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>()),
+            pgroupRootID_, TRANSFER_INTERPOLATION_TAG, theMPISystem()->getGlobalComm(), request);
+  setProcessGroupBusyAndReceive();
+}
+
+void ProcessGroupManager::addInSituProjection(const SparseGridProjection& projection) {
+  sendSignalToProcessGroup(ADD_IN_SITU_PROJECTION);
+  MPIUtils::sendClass(&projection, pgroupRootID_, theMPISystem()->getGlobalComm());
+  setProcessGroupBusyAndReceive();
+}
+
+void ProcessGroupManager::writeSparseGridSliceXdmf(const std::vector<real>& sliceCoords,
+                                                   const LevelVector& sliceLevel,
+                                                   const std::string& filenamePrefix) {
+  sendSignalToProcessGroup(WRITE_SPARSE_GRID_SLICE_XDMF);
+  sendLevelVector(sliceLevel, pgroupRootID_);
+  MPI_Send(sliceCoords.data(), static_cast<int>(sliceCoords.size()),
+           abstraction::getMPIDatatype(abstraction::getabstractionDataType<real>()), pgroupRootID_,
+           TRANSFER_INTERPOLATION_TAG, theMPISystem()->getGlobalComm());
+  MPIUtils::sendClass(&filenamePrefix, pgroupRootID_, theMPISystem()->getGlobalComm());
+  setProcessGroupBusyAndReceive();
+}
+
 void ProcessGroupManager::writeInterpolatedValuesPerGrid(
     const std::vector<real>& interpolationCoordsSerial, const std::string& filenamePrefix) {
   sendSignalToProcessGroup(WRITE_INTERPOLATED_VALUES_PER_GRID);
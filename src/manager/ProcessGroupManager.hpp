@@ -1,6 +1,7 @@
 #ifndef PROCESSGROUPMANAGER_HPP_
 #define PROCESSGROUPMANAGER_HPP_
 
+#include <array>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -11,6 +12,7 @@
 #include "manager/ProcessGroupSignals.hpp"
 #include "mpi/MPISystem.hpp"
 #include "mpi_fault_simulator/MPI-FT.h"
+#include "sparsegrid/SparseGridProjection.hpp"
 #include "task/Task.hpp"
 #include "third_level/ThirdLevelUtils.hpp"
 #include "utils/Types.hpp"
@@ -90,6 +92,8 @@ class ProcessGroupManager {
 
   void getLpNorms(int p, std::map<size_t, double>& norms);
 
+  void getAllLpNorms(std::map<size_t, std::array<double, 3>>& norms);
+
   std::vector<double> evalAnalyticalOnDFG(const LevelVector& leval);
 
   std::vector<double> evalErrorOnDFG(const LevelVector& leval);
@@ -98,6 +102,17 @@ class ProcessGroupManager {
                          std::vector<CombiDataType>& values, MPI_Request* request = nullptr,
                          std::string filenamePrefix = "");
 
+  /** has the group evaluate its combined sparse grid and send back the values */
+  void interpolateValuesOnSparseGrid(const std::vector<real>& interpolationCoordsSerial,
+                                     std::vector<CombiDataType>& values, MPI_Request* request);
+
+  /** registers a projection that the group computes after every combination */
+  void addInSituProjection(const SparseGridProjection& projection);
+
+  /** has the group write a slice of its combined sparse grid to XDMF */
+  void writeSparseGridSliceXdmf(const std::vector<real>& sliceCoords, const LevelVector& sliceLevel,
+                                const std::string& filenamePrefix);
+
   void writeInterpolatedValuesPerGrid(const std::vector<real>& interpolationCoordsSerial,
                                       const std::string& filenamePrefix);
 
@@ -82,6 +82,10 @@ const SignalType COMBINE_READ_DSGS_AND_REDUCE = 45;
 
 const SignalType INTERPOLATE_VALUES_AND_SEND_BACK = 46;
 const SignalType INTERPOLATE_VALUES_AND_WRITE_SINGLE_FILE = 47;
+const SignalType INTERPOLATE_VALUES_ON_SPARSE_GRID_AND_SEND_BACK = 48;
+const SignalType GET_ALL_LP_NORMS = 49;
+const SignalType WRITE_SPARSE_GRID_SLICE_XDMF = 50;
+const SignalType ADD_IN_SITU_PROJECTION = 51;
 
 typedef int NormalizationType;
 const NormalizationType NO_NORMALIZATION = 0;
@@ -3,6 +3,7 @@
 #include "combicom/CombiCom.hpp"
 #include "manager/InterpolationWorker.hpp"
 #include "manager/ProcessGroupSignals.hpp"
+#include "mpi/CommunicationCounters.hpp"
 #include "mpi/MPIUtils.hpp"
 #include "loadmodel/LearningLoadModel.hpp"
 #include "mpi/MPISystem.hpp"
@@ -13,8 +14,12 @@
 #include "boost/lexical_cast.hpp"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
 #include <iostream>
 #include <random>
 #include <string>
@@ -69,6 +74,20 @@ LevelVector receiveLevalAndBroadcast(DimType dim) {
   return leval;
 }
 
+std::vector<real> receiveSliceCoordsAndBroadcast(DimType dim) {
+  // one coordinate per dimension, NaN for the dimensions that are not sliced
+  std::vector<real> sliceCoords(dim);
+  auto realType = abstraction::getMPIDatatype(abstraction::getabstractionDataType<real>());
+  MASTER_EXCLUSIVE_SECTION {
+    MPI_Recv(sliceCoords.data(), static_cast<int>(dim), realType,
+             theMPISystem()->getManagerRank(), TRANSFER_INTERPOLATION_TAG,
+             theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
+  }
+  MPI_Bcast(sliceCoords.data(), static_cast<int>(dim), realType, theMPISystem()->getMasterRank(),
+            theMPISystem()->getLocalComm());
+  return sliceCoords;
+}
+
 std::vector<std::vector<real>> receiveAndBroadcastInterpolationCoords(DimType dim) {
   std::vector<std::vector<real>> interpolationCoords;
   std::vector<real> interpolationCoordsSerial;
@@ -329,16 +348,26 @@ SignalType ProcessGroupWorker::wait() {
       }
       Stats::stopEvent("get max norm");
     } break;
+    case GET_ALL_LP_NORMS: {  // evaluate max, L1 and L2 norm on dfgs and send
+      Stats::startEvent("get all norms");
+      auto lpnorms = this->getAllLpNorms();
+      MASTER_EXCLUSIVE_SECTION {
+        MPI_Send(lpnorms.data(), static_cast<int>(lpnorms.size()), MPI_DOUBLE,
+                 theMPISystem()->getManagerRank(), TRANSFER_NORM_TAG,
+                 theMPISystem()->getGlobalComm());
+      }
+      Stats::stopEvent("get all norms");
+    } break;
     case INTERPOLATE_VALUES: {  // interpolate values on given coordinates
       Stats::startEvent("interpolate values");
-      auto values =
-          interpolateValues(receiveAndBroadcastInterpolationCoords(combiParameters_.getDim()));
+      auto values = interpolateValues(
+          receiveAndBroadcastInterpolationCoords(combiParameters_.getDim()), true);
       Stats::stopEvent("interpolate values");
     } break;
     case INTERPOLATE_VALUES_AND_SEND_BACK: {
       Stats::startEvent("interpolate values");
-      auto values =
-          interpolateValues(receiveAndBroadcastInterpolationCoords(combiParameters_.getDim()));
+      auto values = interpolateValues(
+          receiveAndBroadcastInterpolationCoords(combiParameters_.getDim()), true);
       // send result
       MASTER_EXCLUSIVE_SECTION {
         MPI_Send(values.data(), values.size(),
@@ -348,6 +377,37 @@ SignalType ProcessGroupWorker::wait() {
       }
       Stats::stopEvent("interpolate values");
     } break;
+    case INTERPOLATE_VALUES_ON_SPARSE_GRID_AND_SEND_BACK: {
+      Stats::startEvent("interpolate values on sparse grid");
+      auto values = interpolateValuesOnSparseGrid(
+          receiveAndBroadcastInterpolationCoords(combiParameters_.getDim()));
+      // send result
+      MASTER_EXCLUSIVE_SECTION {
+        MPI_Send(values.data(), values.size(),
+                 abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>()),
+                 theMPISystem()->getManagerRank(), TRANSFER_INTERPOLATION_TAG,
+                 theMPISystem()->getGlobalComm());
+      }
+      Stats::stopEvent("interpolate values on sparse grid");
+    } break;
+    case ADD_IN_SITU_PROJECTION: {
+      SparseGridProjection projection;
+      MASTER_EXCLUSIVE_SECTION {
+        MPIUtils::receiveClass(&projection, theMPISystem()->getManagerRank(),
+                               theMPISystem()->getGlobalComm());
+      }
+      MPIUtils::broadcastClass(&projection, theMPISystem()->getMasterRank(),
+                               theMPISystem()->getLocalComm());
+      addInSituProjection(projection);
+    } break;
+    case WRITE_SPARSE_GRID_SLICE_XDMF: {
+      Stats::startEvent("write sparse grid slice");
+      auto sliceLevel = receiveLevalAndBroadcast(combiParameters_.getDim());
+      auto sliceCoords = receiveSliceCoordsAndBroadcast(combiParameters_.getDim());
+      auto filenamePrefix = receiveStringFromManagerAndBroadcastToGroup();
+      writeSparseGridSliceXdmf(filenamePrefix, sliceCoords, sliceLevel);
+      Stats::stopEvent("write sparse grid slice");
+    } break;
     case INTERPOLATE_VALUES_AND_WRITE_SINGLE_FILE: {
       Stats::startEvent("interpolate values");
       writeInterpolatedValuesSingleFile(
@@ -460,6 +520,7 @@ void ProcessGroupWorker::exit() {
     };
   }
   this->getTaskWorker().deleteTasks();
+  CommunicationCounters::writeTotalsToStats();
 }
 
 void ProcessGroupWorker::initCombinedDSGVector() {
@@ -470,6 +531,134 @@ void ProcessGroupWorker::initCombinedDSGVector() {
       combiParameters_.getCombinationVariant());
 }
 
+std::pair<CombinationVariant, uint32_t> ProcessGroupWorker::tuneCombination(
+    const std::string& tuningFile, uint32_t memoryBudgetMiB,
+    const std::vector<CombinationVariant>& variants,
+    const std::vector<uint32_t>& chunkSizesInMebibyte, int numRepetitions) {
+  assert(combiParametersSet_);
+  assert(this->getSparseGridWorker().getNumberOfGrids() == 0 &&
+         "tune before initCombinedDSGVector");
+  const auto& worldComm = theMPISystem()->getWorldComm();
+  const bool isWorldRoot = getCommRank(worldComm) == 0;
+
+  // the setup the tuning is valid for
+  std::stringstream keyStream;
+  keyStream << "groups " << theMPISystem()->getNumGroups() << " procs "
+            << theMPISystem()->getNumProcs() << " threads "
+            << theMPISystem()->getNumOpenMPThreads() << " lmin "
+            << combiParameters_.getLMin() << " lmax " << combiParameters_.getLMax()
+            << " grids " << combiParameters_.getNumGrids();
+  const std::string key = keyStream.str();
+
+  // variant and chunk size from a previous run, if there is one
+  std::array<int64_t, 3> previousChoice{0, 0, 0};
+  if (isWorldRoot && std::filesystem::exists(tuningFile)) {
+    std::ifstream in(tuningFile);
+    std::string fileKey;
+    std::getline(in, fileKey);
+    int64_t variant = 0, chunkSize = 0;
+    if (fileKey == key && (in >> variant >> chunkSize)) {
+      previousChoice = {1, variant, chunkSize};
+    }
+  }
+  MPI_Bcast(previousChoice.data(), 3, MPI_INT64_T, 0, worldComm);
+
+  std::pair<CombinationVariant, uint32_t> choice;
+  if (previousChoice[0] == 1) {
+    choice = {static_cast<CombinationVariant>(previousChoice[1]),
+              static_cast<uint32_t>(previousChoice[2])};
+  } else {
+    // the tasks' data is overwritten by the extraction, so keep a copy
+    std::vector<std::vector<CombiDataType>> taskData;
+    for (const auto& t : this->getTaskWorker().getTasks()) {
+      for (int g = 0; g < combiParameters_.getNumGrids(); ++g) {
+        const auto& dfg = t->getDistributedFullGrid(g);
+        taskData.emplace_back(dfg.getData(), dfg.getData() + dfg.getNrLocalElements());
+      }
+    }
+
+    double fastestTime = std::numeric_limits<double>::max();
+    for (const auto& variant : variants) {
+      for (const auto& chunkSize : chunkSizesInMebibyte) {
+        SparseGridWorker candidate(this->getTaskWorker());
+        candidate.initCombinedUniDSGVector(
+            combiParameters_.getLMin(), combiParameters_.getLMax(),
+            combiParameters_.getLMaxReductionVector(), combiParameters_.getNumGrids(), variant);
+
+        // the non-chunked variants hold the whole sparse grid and a Kahan buffer of (at most)
+        // the same size, the chunked one a chunk per thread
+        uint64_t numElements = 0;
+        for (const auto& dsg : candidate.getCombinedUniDSGVector()) {
+          numElements += dsg->getAccumulatedDataSize();
+        }
+        if (variant == CombinationVariant::chunkedOutgroupSparseGridReduce) {
+          numElements = std::min(
+              numElements,
+              static_cast<uint64_t>(CombiCom::getGlobalReduceChunkSize<CombiDataType>(chunkSize)));
+        } else {
+          numElements *= 2;
+        }
+        uint64_t bytesNeeded = numElements * sizeof(CombiDataType);
+        MPI_Allreduce(MPI_IN_PLACE, &bytesNeeded, 1, MPI_UINT64_T, MPI_MAX, worldComm);
+        if (memoryBudgetMiB > 0 && bytesNeeded > CombiCom::MiBtoBytes(memoryBudgetMiB)) {
+          continue;
+        }
+
+        double time = std::numeric_limits<double>::max();
+        for (int repetition = 0; repetition < numRepetitions; ++repetition) {
+          MPI_Barrier(worldComm);
+          auto start = std::chrono::high_resolution_clock::now();
+          if (variant == CombinationVariant::chunkedOutgroupSparseGridReduce) {
+            candidate.collectReduceDistribute<false>(variant, chunkSize,
+                                                     combiParameters_.isReduceReproducible());
+          } else {
+            candidate.reduceLocalAndGlobal(variant, chunkSize, MPI_PROC_NULL,
+                                           combiParameters_.isReduceReproducible());
+            candidate.distributeCombinedSolutionToTasks();
+          }
+          double duration = std::chrono::duration<double>(
+                                std::chrono::high_resolution_clock::now() - start)
+                                .count();
+          MPI_Allreduce(MPI_IN_PLACE, &duration, 1, MPI_DOUBLE, MPI_MAX, worldComm);
+          time = std::min(time, duration);
+        }
+        if (time < fastestTime) {
+          fastestTime = time;
+          choice = {variant, chunkSize};
+        }
+        if (isWorldRoot) {
+          std::cout << getTimeStamp() << "tuning: variant " << static_cast<int>(variant)
+                    << ", chunk size " << chunkSize << " MiB: " << time << " s" << std::endl;
+        }
+      }
+    }
+    if (fastestTime == std::numeric_limits<double>::max()) {
+      throw std::runtime_error("tuneCombination: no candidate fits into the memory budget");
+    }
+
+    size_t i = 0;
+    for (const auto& t : this->getTaskWorker().getTasks()) {
+      for (int g = 0; g < combiParameters_.getNumGrids(); ++g) {
+        std::copy(taskData[i].cbegin(), taskData[i].cend(),
+                  t->getDistributedFullGrid(g).getData());
+        ++i;
+      }
+    }
+
+    if (isWorldRoot) {
+      std::ofstream out(tuningFile);
+      out << key << std::endl
+          << static_cast<int>(choice.first) << " " << choice.second << std::endl;
+    }
+  }
+
+  combiParameters_.setCombinationVariant(choice.first);
+  combiParameters_.setChunkSizeInMebibybtePerThread(choice.second);
+  Stats::setAttribute("combination variant", std::to_string(static_cast<int>(choice.first)));
+  Stats::setAttribute("chunk size MiB", std::to_string(choice.second));
+  return choice;
+}
+
 void ProcessGroupWorker::combineSystemWide() {
   Stats::startEvent("hierarchize");
   this->getTaskWorker().hierarchizeFullGrids(
@@ -480,8 +669,10 @@ void ProcessGroupWorker::combineSystemWide() {
   Stats::startEvent("reduce");
   this->getSparseGridWorker().reduceLocalAndGlobal(
       combiParameters_.getCombinationVariant(), combiParameters_.getChunkSizeInMebibybtePerThread(),
-      MPI_PROC_NULL);
+      MPI_PROC_NULL, combiParameters_.isReduceReproducible());
   Stats::stopEvent("reduce");
+
+  this->writeInSituProjections();
 }
 
 void ProcessGroupWorker::combineSystemWideAndWrite(const std::string& writeSparseGridFile,
@@ -499,12 +690,14 @@ void ProcessGroupWorker::combineSystemWideAndWrite(const std::string& writeSpars
       assert(!getExtraDSGVector().empty());
       this->getSparseGridWorker().collectReduceDistribute<true>(
           combiParameters_.getCombinationVariant(),
-          combiParameters_.getChunkSizeInMebibybtePerThread());
+          combiParameters_.getChunkSizeInMebibybtePerThread(),
+          combiParameters_.isReduceReproducible());
     }
     else {
       this->getSparseGridWorker().collectReduceDistribute<false>(
           combiParameters_.getCombinationVariant(),
-          combiParameters_.getChunkSizeInMebibybtePerThread());
+          combiParameters_.getChunkSizeInMebibybtePerThread(),
+          combiParameters_.isReduceReproducible());
     }
     Stats::stopEvent("reduce/distribute");
   } else {
@@ -512,7 +705,7 @@ void ProcessGroupWorker::combineSystemWideAndWrite(const std::string& writeSpars
     this->getSparseGridWorker().reduceLocalAndGlobal(
         combiParameters_.getCombinationVariant(),
         combiParameters_.getChunkSizeInMebibybtePerThread(),
-        theMPISystem()->getOutputRankInGlobalReduceComm());
+        theMPISystem()->getOutputRankInGlobalReduceComm(), combiParameters_.isReduceReproducible());
     Stats::stopEvent("reduce");
   }
 
@@ -526,6 +719,7 @@ void ProcessGroupWorker::dehierarchizeAllTasks() {
       combiParameters_.getBoundary(), combiParameters_.getHierarchizationDims(),
       combiParameters_.getHierarchicalBases(), combiParameters_.getLMin());
   Stats::stopEvent("dehierarchize");
+  CommunicationCounters::finishStep(currentCombi_);
   currentCombi_++;
 }
 
@@ -541,17 +735,21 @@ void ProcessGroupWorker::combineAtOnce() {
     Stats::startEvent("reduce/distribute");
     this->getSparseGridWorker().collectReduceDistribute<false>(
         combiParameters_.getCombinationVariant(),
-        combiParameters_.getChunkSizeInMebibybtePerThread());
+        combiParameters_.getChunkSizeInMebibybtePerThread(),
+        combiParameters_.isReduceReproducible());
     Stats::stopEvent("reduce/distribute");
   } else {
     Stats::startEvent("reduce");
     this->getSparseGridWorker().reduceLocalAndGlobal(
         combiParameters_.getCombinationVariant(),
-        combiParameters_.getChunkSizeInMebibybtePerThread(), MPI_PROC_NULL);
+        combiParameters_.getChunkSizeInMebibybtePerThread(), MPI_PROC_NULL,
+        combiParameters_.isReduceReproducible());
     Stats::stopEvent("reduce");
     Stats::startEvent("distribute");
     this->getSparseGridWorker().distributeCombinedSolutionToTasks();
     Stats::stopEvent("distribute");
+    // the chunked variant does not keep the whole combined sparse grid
+    this->writeInSituProjections();
   }
 
   this->dehierarchizeAllTasks();
@@ -583,6 +781,10 @@ std::vector<double> ProcessGroupWorker::getLpNorms(int p) const {
   return this->getTaskWorker().getLpNorms(p);
 }
 
+std::vector<double> ProcessGroupWorker::getAllLpNorms() const {
+  return this->getTaskWorker().getAllLpNorms();
+}
+
 void ProcessGroupWorker::doDiagnostics() {
   // receive taskID and broadcast
   size_t taskID;
@@ -609,28 +811,113 @@ void ProcessGroupWorker::doDiagnostics(size_t taskID) {
   assert(false && "this taskID is not here");
 }
 
+DistributedFullGrid<CombiDataType> ProcessGroupWorker::getReferenceGrid() const {
+  const auto& lmax = combiParameters_.getLMax();
+  return DistributedFullGrid<CombiDataType>(
+      static_cast<DimType>(lmax.size()), lmax, theMPISystem()->getLocalComm(),
+      combiParameters_.getBoundary(), nullptr, combiParameters_.getParallelization(),
+      combiParameters_.getForwardDecomposition(), combiParameters_.getDecomposition());
+}
+
 std::vector<CombiDataType> ProcessGroupWorker::interpolateValues(
-    const std::vector<std::vector<real>>& interpolationCoords) const {
+    const std::vector<std::vector<real>>& interpolationCoords, bool onlyOutputMaster) {
   assert(combiParameters_.getNumGrids() == 1 && "interpolate only implemented for 1 species!");
+  if (!uniformDecomposition) {
+    // no common partitioning to assign the points to, reduce all values
+    return combigrid::interpolateValues<CombiDataType>(this->getTaskWorker().getTasks(),
+                                                       interpolationPlans_, interpolationCoords);
+  }
+  const auto referenceGrid = this->getReferenceGrid();
   return combigrid::interpolateValues<CombiDataType>(this->getTaskWorker().getTasks(),
-                                                     interpolationCoords);
+                                                     interpolationPlans_, interpolationCoords,
+                                                     &referenceGrid, onlyOutputMaster);
+}
+
+std::vector<CombiDataType> ProcessGroupWorker::interpolateValuesOnSparseGrid(
+    const std::vector<std::vector<real>>& interpolationCoords) const {
+  assert(combiParameters_.getNumGrids() == 1 && "interpolate only implemented for 1 species!");
+  if (!uniformDecomposition) {
+    throw std::runtime_error(
+        "interpolateValuesOnSparseGrid not implemented for non-uniform decomposition");
+  }
+  return this->getSparseGridWorker().interpolateValuesOnSparseGrid(
+      interpolationCoords, combiParameters_.getLMax(), combiParameters_.getBoundary(),
+      combiParameters_.getHierarchizationDims(), combiParameters_.getHierarchicalBases(),
+      combiParameters_.getLMin(), combiParameters_.getParallelization(),
+      combiParameters_.getDecomposition(), combiParameters_.getForwardDecomposition());
+}
+
+void ProcessGroupWorker::addInSituProjection(const SparseGridProjection& projection) {
+  assert(projection.sliceCoords.size() == combiParameters_.getDim());
+  inSituProjections_.push_back(projection);
+}
+
+void ProcessGroupWorker::writeInSituProjections() const {
+  if (inSituProjections_.empty()) return;
+  assert(combiParameters_.getNumGrids() == 1 && "projections only implemented for 1 species!");
+  // every group holds the combined sparse grid, the last one does the output
+  OTHER_OUTPUT_GROUP_EXCLUSIVE_SECTION {
+    Stats::startEvent("in-situ projections");
+    for (const auto& projection : inSituProjections_) {
+      auto values = this->getSparseGridWorker().getProjectedValues(
+          projection, combiParameters_.getLMax(), combiParameters_.getBoundary(),
+          combiParameters_.getHierarchizationDims(), combiParameters_.getHierarchicalBases(),
+          combiParameters_.getLMin(), combiParameters_.getParallelization(),
+          combiParameters_.getDecomposition(), combiParameters_.getForwardDecomposition());
+      MASTER_EXCLUSIVE_SECTION {
+        std::string groupName = "sparse_grid";
+        std::string datasetName = "projected_" + std::to_string(currentCombi_);
+        std::string valuesWriteFilename =
+            projection.name + "_" + std::to_string(currentCombi_) + ".h5";
+        h5io::writeValuesToH5File(values, valuesWriteFilename, groupName, datasetName,
+                                  this->getTasks().empty()
+                                      ? std::numeric_limits<real>::quiet_NaN()
+                                      : this->getTasks().front()->getCurrentTime());
+      }
+    }
+    Stats::stopEvent("in-situ projections");
+  }
+}
+
+void ProcessGroupWorker::writeSparseGridSliceXdmf(const std::string& filenamePrefix,
+                                                  const std::vector<real>& sliceCoords,
+                                                  const LevelVector& sliceLevel) const {
+  assert(combiParameters_.getNumGrids() == 1 && "slice output only implemented for 1 species!");
+  if (!uniformDecomposition) {
+    throw std::runtime_error(
+        "writeSparseGridSliceXdmf not implemented for non-uniform decomposition");
+  }
+  this->getSparseGridWorker().writeSparseGridSliceXdmf(
+      filenamePrefix, sliceCoords, sliceLevel, combiParameters_.getLMax(),
+      combiParameters_.getBoundary(), combiParameters_.getHierarchizationDims(),
+      combiParameters_.getHierarchicalBases(), combiParameters_.getLMin(),
+      combiParameters_.getParallelization(), combiParameters_.getDecomposition(),
+      combiParameters_.getForwardDecomposition());
 }
 
 void ProcessGroupWorker::writeInterpolatedValuesPerGrid(
     const std::vector<std::vector<real>>& interpolationCoords,
-    const std::string& fileNamePrefix) const {
+    const std::string& fileNamePrefix) {
   assert(combiParameters_.getNumGrids() == 1 && "interpolate only implemented for 1 species!");
-  combigrid::writeInterpolatedValuesPerGrid(this->getTaskWorker().getTasks(), interpolationCoords,
-                                            fileNamePrefix, currentCombi_);
+  combigrid::writeInterpolatedValuesPerGrid(this->getTaskWorker().getTasks(), interpolationPlans_,
+                                            interpolationCoords, fileNamePrefix, currentCombi_);
 }
 
 void ProcessGroupWorker::writeInterpolatedValuesSingleFile(
     const std::vector<std::vector<real>>& interpolationCoords,
-    const std::string& filenamePrefix) const {
+    const std::string& filenamePrefix) {
   // all processes interpolate
   assert(combiParameters_.getNumGrids() == 1 && "interpolate only implemented for 1 species!");
+  if (!uniformDecomposition) {
+    combigrid::writeInterpolatedValuesSingleFile<CombiDataType>(
+        this->getTaskWorker().getTasks(), interpolationPlans_, interpolationCoords, filenamePrefix,
+        currentCombi_);
+    return;
+  }
+  const auto referenceGrid = this->getReferenceGrid();
   combigrid::writeInterpolatedValuesSingleFile<CombiDataType>(
-      this->getTaskWorker().getTasks(), interpolationCoords, filenamePrefix, currentCombi_);
+      this->getTaskWorker().getTasks(), interpolationPlans_, interpolationCoords, filenamePrefix,
+      currentCombi_, &referenceGrid);
 }
 
 void ProcessGroupWorker::writeSparseGridMinMaxCoefficients(
@@ -769,7 +1056,9 @@ void ProcessGroupWorker::combineThirdLevel() {
 
   // wait for bcasts to other pgs in globalReduceComm
   Stats::startEvent("wait for bcasts");
+  CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::broadcast);
   for (MPI_Request& request : requests) {
+    CommunicationCounters::WaitTimer waitTimer(theMPISystem()->getGlobalReduceComm(), 0, 0);
     auto returnedValue = MPI_Wait(&request, MPI_STATUS_IGNORE);
     assert(returnedValue == MPI_SUCCESS);
   }
@@ -975,8 +1264,12 @@ void ProcessGroupWorker::waitForThirdLevelCombiResult(bool fromOutputGroup) {
   MPI_Request request;
   this->getSparseGridWorker().startSingleBroadcastDSGs(combiParameters_.getCombinationVariant(),
                                                        broadcastSender, &request);
-  auto returnedValue = MPI_Wait(&request, MPI_STATUS_IGNORE);
-  assert(returnedValue == MPI_SUCCESS);
+  {
+    CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::broadcast);
+    CommunicationCounters::WaitTimer waitTimer(globalReduceComm, 0, 0);
+    [[maybe_unused]] auto returnedValue = MPI_Wait(&request, MPI_STATUS_IGNORE);
+    assert(returnedValue == MPI_SUCCESS);
+  }
   Stats::stopEvent("wait for bcasts");
 
   updateFullFromCombinedSparseGrids();
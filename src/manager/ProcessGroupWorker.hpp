@@ -2,6 +2,7 @@
 #define PROCESSGROUPWORKER_HPP_
 
 #include "manager/CombiParameters.hpp"
+#include "manager/InterpolationWorker.hpp"
 #include "manager/ProcessGroupSignals.hpp"
 #include "manager/SparseGridWorker.hpp"
 #include "manager/TaskWorker.hpp"
@@ -32,6 +33,28 @@ class ProcessGroupWorker {
    * global reduce comm*/
   void initCombinedDSGVector();
 
+  /**
+   * @brief chooses the combination variant and chunk size for the following combinations
+   *
+   * If tuningFile exists and was written for the same setup (groups, ranks, threads, scheme),
+   * its choice is used. Otherwise, each candidate pair is timed on the real sparse grid of the
+   * current tasks (reduce and extract, numRepetitions times, fastest run counts), candidates
+   * that would need more than memoryBudgetMiB per rank for the sparse grid are skipped
+   * (0 = no limit), and the fastest choice is written to tuningFile.
+   * Has to be called on all workers after the tasks are initialized and before
+   * initCombinedDSGVector; the tasks' data is left unchanged.
+   *
+   * @return the chosen combination variant and chunk size in MiB per thread
+   */
+  std::pair<CombinationVariant, uint32_t> tuneCombination(
+      const std::string& tuningFile, uint32_t memoryBudgetMiB = 0,
+      const std::vector<CombinationVariant>& variants =
+          {CombinationVariant::sparseGridReduce, CombinationVariant::subspaceReduce,
+           CombinationVariant::outgroupSparseGridReduce,
+           CombinationVariant::chunkedOutgroupSparseGridReduce},
+      const std::vector<uint32_t>& chunkSizesInMebibyte = {1, 4, 16, 64, 256},
+      int numRepetitions = 2);
+
   /** extracts and dehierarchizes */
   void updateFullFromCombinedSparseGrids();
 
@@ -58,16 +81,42 @@ class ProcessGroupWorker {
   /** calculate the Lp Norm for each individual task */
   std::vector<double> getLpNorms(int p) const;
 
-  /** interpolate values on all tasks' component grids */
+  /** calculate the maximum, L1 and L2 norm for each individual task, ordered by task */
+  std::vector<double> getAllLpNorms() const;
+
+  /** interpolate values on all tasks' component grids, reusing the interpolation plans if the
+   * coordinates are the same as in the last call
+   * @param onlyOutputMaster if true, the values are only returned on the master of the last
+   * process group (and empty everywhere else), which saves communication */
   std::vector<CombiDataType> interpolateValues(
+      const std::vector<std::vector<real>>& interpolationCoordinates,
+      bool onlyOutputMaster = false);
+
+  /** interpolate values directly on the combined sparse grid, without the component grids */
+  std::vector<CombiDataType> interpolateValuesOnSparseGrid(
       const std::vector<std::vector<real>>& interpolationCoordinates) const;
 
+  /**
+   * @brief register a slice / marginal of the combined solution that is computed from the
+   * combined sparse grid after every combination, and written to
+   * <projection.name>_<combination>.h5 by the last process group
+   */
+  void addInSituProjection(const SparseGridProjection& projection);
+
+  /** compute and write all registered in-situ projections, cf. addInSituProjection */
+  void writeInSituProjections() const;
+
+  /** write a (downsampled) slice of the combined sparse grid to XDMF, without the full grid */
+  void writeSparseGridSliceXdmf(const std::string& filenamePrefix,
+                                const std::vector<real>& sliceCoords,
+                                const LevelVector& sliceLevel) const;
+
   /** interpolate values on all tasks' component grids and write results to file */
   void writeInterpolatedValuesPerGrid(const std::vector<std::vector<real>>& interpolationCoords,
-                                      const std::string& fileNamePrefix) const;
+                                      const std::string& fileNamePrefix);
 
   void writeInterpolatedValuesSingleFile(const std::vector<std::vector<real>>& interpolationCoords,
-                                         const std::string& filenamePrefix) const;
+                                         const std::string& filenamePrefix);
 
   /** write the highest and smallest sparse grid coefficient per subspace */
   void writeSparseGridMinMaxCoefficients(const std::string& fileNamePrefix) const;
@@ -178,11 +227,19 @@ class ProcessGroupWorker {
 
   IndexType currentCombi_;  /// current combination; increased after every combination
 
+  std::vector<SparseGridProjection> inSituProjections_;  /// evaluated after every combination
+
+  InterpolationPlanCache interpolationPlans_;  /// for the last interpolation coordinates
+
   TaskWorker& getTaskWorker() { return taskWorker_; }
 
   SparseGridWorker& getSparseGridWorker() { return sgWorker_; }
 
   void receiveAndInitializeTask();
+
+  /** a grid without data that describes how the process group partitions the domain at lmax,
+   * the same in all process groups */
+  DistributedFullGrid<CombiDataType> getReferenceGrid() const;
 };
 
 inline CombiParameters& ProcessGroupWorker::getCombiParameters() {
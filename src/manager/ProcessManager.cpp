@@ -449,6 +449,15 @@ std::map<size_t, double> ProcessManager::getLpNorms(int p) {
   return norms;
 }
 
+std::map<size_t, std::array<double, 3>> ProcessManager::getAllLpNorms() {
+  std::map<size_t, std::array<double, 3>> norms;
+
+  for (const auto& pg : pgroups_) {
+    pg->getAllLpNorms(norms);
+  }
+  return norms;
+}
+
 double ProcessManager::getLpNorm(int p) {
   std::map<size_t, double> norms = this->getLpNorms(p);
 
@@ -493,6 +502,38 @@ std::vector<CombiDataType> ProcessManager::interpolateValues(
   return values;
 }
 
+std::vector<CombiDataType> ProcessManager::interpolateValuesOnSparseGrid(
+    const std::vector<std::vector<real>>& interpolationCoords) {
+  auto numValues = interpolationCoords.size();
+  auto values = std::vector<CombiDataType>(numValues, std::numeric_limits<double>::quiet_NaN());
+  MPI_Request request = MPI_REQUEST_NULL;
+
+  // every group holds the whole combined sparse grid, so one group suffices
+  std::vector<real> interpolationCoordsSerial = serializeInterpolationCoords(interpolationCoords);
+  pgroups_[pgroups_.size() - 1]->interpolateValuesOnSparseGrid(interpolationCoordsSerial, values,
+                                                               &request);
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+  return values;
+}
+
+void ProcessManager::addInSituProjection(const SparseGridProjection& projection) {
+  this->waitAllFinished();
+  // every group stores it, only the last one computes it
+  for (const auto& pg : pgroups_) {
+    pg->addInSituProjection(projection);
+  }
+  this->waitAllFinished();
+}
+
+void ProcessManager::writeSparseGridSliceXdmf(const std::vector<real>& sliceCoords,
+                                              const LevelVector& sliceLevel,
+                                              const std::string& filenamePrefix) {
+  // every group holds the whole combined sparse grid, so one group suffices
+  pgroups_[pgroups_.size() - 1]->writeSparseGridSliceXdmf(sliceCoords, sliceLevel,
+                                                          filenamePrefix);
+  this->waitAllFinished();
+}
+
 void ProcessManager::writeInterpolatedValuesPerGrid(
     const std::vector<std::vector<real>>& interpolationCoords, std::string filenamePrefix) {
   // send interpolation coords as a single array
@@ -128,11 +128,41 @@ class ProcessManager {
 
   std::map<size_t, double> getLpNorms(int p = 2);
 
+  /** the maximum, L1 and L2 norm of each task's grid (indexed by p), from one signal per group */
+  std::map<size_t, std::array<double, 3>> getAllLpNorms();
+
   double getLpNorm(int p = 2);
 
   std::vector<CombiDataType> interpolateValues(
       const std::vector<std::vector<real>>& interpolationCoords);
 
+  /**
+   * @brief evaluates the combined solution on its sparse grid representation in one process
+   * group, instead of on all component grids; requires hat bases and the sparse grid data of the
+   * last combination to be present in the groups
+   */
+  std::vector<CombiDataType> interpolateValuesOnSparseGrid(
+      const std::vector<std::vector<real>>& interpolationCoords);
+
+  /**
+   * @brief registers a slice / marginal of the combined solution, which is then computed from the
+   * combined sparse grid after every combination (in-situ) and written to
+   * <projection.name>_<combination>.h5; requires hat bases
+   */
+  void addInSituProjection(const SparseGridProjection& projection);
+
+  /**
+   * @brief writes the combined solution on a uniform grid of up to three dimensions to
+   * filenamePrefix.bin and filenamePrefix.xdmf, evaluated on the sparse grid in one process
+   * group; the output is written in parallel, and no full grid of the sparse grid's levels is
+   * created
+   *
+   * @param sliceCoords per dimension, the coordinate of the slice, or NaN if the dimension is kept
+   * @param sliceLevel per dimension, the level of the output grid in the kept dimensions
+   */
+  void writeSparseGridSliceXdmf(const std::vector<real>& sliceCoords, const LevelVector& sliceLevel,
+                                const std::string& filenamePrefix);
+
   void writeInterpolatedValuesSingleFile(const std::vector<std::vector<real>>& interpolationCoords,
                                          std::string filenamePrefix);
 
@@ -6,6 +6,7 @@
 #include "manager/TaskWorker.hpp"
 #include "mpi/MPISystem.hpp"
 #include "mpi/MPIUtils.hpp"
+#include "sparsegrid/DistributedSparseGridEvaluator.hpp"
 #include "sparsegrid/DistributedSparseGridIO.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
 
@@ -23,7 +24,8 @@ class SparseGridWorker {
 
   template <bool keepValuesInExtraSparseGrid = false>
   inline void collectReduceDistribute(CombinationVariant combinationVariant,
-                                      uint32_t maxMiBToSendPerThread);
+                                      uint32_t maxMiBToSendPerThread,
+                                      bool reproducibleReduce = false);
 
   inline void copyFromExtraDsgToPartialDSG(int gridNumber = 0);
 
@@ -68,6 +70,47 @@ class SparseGridWorker {
       const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
       const std::vector<int>& parallelization, const std::vector<LevelVector>& decomposition) const;
 
+  /**
+   * @brief evaluates the combined sparse grid (of the first grid) directly on its hierarchical
+   * surpluses, cf. DistributedSparseGridEvaluator; only for hat bases
+   *
+   * @param lmax the level of the finest component grid, the decomposition refers to this level
+   */
+  inline std::vector<CombiDataType> interpolateValuesOnSparseGrid(
+      const std::vector<std::vector<real>>& interpolationCoords, const LevelVector& lmax,
+      const std::vector<BoundaryType>& boundary, const std::vector<bool>& hierarchizationDims,
+      const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+      const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+      bool forwardDecomposition) const;
+
+  /**
+   * @brief writes the combined sparse grid (of the first grid) on a uniform grid of up to three
+   * dimensions to XDMF, cf. DistributedSparseGridEvaluator::writeSliceXdmf; only for hat bases
+   *
+   * @param sliceCoords per dimension, the coordinate of the slice, or NaN if the dimension is kept
+   * @param sliceLevel per dimension, the level of the output grid in the kept dimensions
+   */
+  inline void writeSparseGridSliceXdmf(
+      const std::string& filenamePrefix, const std::vector<real>& sliceCoords,
+      const LevelVector& sliceLevel, const LevelVector& lmax,
+      const std::vector<BoundaryType>& boundary, const std::vector<bool>& hierarchizationDims,
+      const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+      const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+      bool forwardDecomposition) const;
+
+  /**
+   * @brief evaluates a slice / marginal of the combined sparse grid (of the first grid), cf.
+   * DistributedSparseGridEvaluator::getProjectedValues; only for hat bases
+   *
+   * @return the projection's values on the master rank of the process group
+   */
+  inline std::vector<CombiDataType> getProjectedValues(
+      const SparseGridProjection& projection, const LevelVector& lmax,
+      const std::vector<BoundaryType>& boundary, const std::vector<bool>& hierarchizationDims,
+      const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+      const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+      bool forwardDecomposition) const;
+
   inline void maxReduceSubspaceSizesInOutputGroup();
 
   inline int readDSGsFromDisk(const std::string& filenamePrefix, bool alwaysReadFullDSG = false);
@@ -82,10 +125,12 @@ class SparseGridWorker {
   inline int reduceExtraSubspaceSizes(const std::string& filenameToRead,
                                       CombinationVariant combinationVariant, bool overwrite);
 
-  /* reduction within and between process groups */
+  /* reduction within and between process groups; if reproducibleReduce, the reduction between
+   * process groups is bitwise reproducible (cf. CombiCom::reproducibleReduce) */
   inline void reduceLocalAndGlobal(CombinationVariant combinationVariant,
                                    uint32_t maxMiBToSendPerThread,
-                                   RankType globalReduceRankThatCollects = MPI_PROC_NULL);
+                                   RankType globalReduceRankThatCollects = MPI_PROC_NULL,
+                                   bool reproducibleReduce = false);
 
   inline void reduceSubspaceSizesBetweenGroups(CombinationVariant combinationVariant);
 
@@ -105,6 +150,17 @@ class SparseGridWorker {
   inline void zeroDsgsData(CombinationVariant combinationVariant);
 
  private:
+  /**
+   * @brief checks that the combined sparse grid can be evaluated directly and creates an evaluator
+   * for it, cf. DistributedSparseGridEvaluator
+   */
+  inline DistributedSparseGridEvaluator<CombiDataType> getSparseGridEvaluator(
+      const LevelVector& lmax, const std::vector<BoundaryType>& boundary,
+      const std::vector<bool>& hierarchizationDims,
+      const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+      const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+      bool forwardDecomposition) const;
+
   TaskWorker& taskWorkerRef_;
 
   /**
@@ -136,7 +192,8 @@ inline SparseGridWorker::SparseGridWorker(TaskWorker& taskWorkerToReference)
 
 template <bool keepValuesInExtraSparseGrid>
 inline void SparseGridWorker::collectReduceDistribute(CombinationVariant combinationVariant,
-                                                      uint32_t maxMiBToSendPerThread) {
+                                                      uint32_t maxMiBToSendPerThread,
+                                                      bool reproducibleReduce) {
   auto numGrids = this->getNumberOfGrids();
   assert(combinationVariant == CombinationVariant::chunkedOutgroupSparseGridReduce);
   assert(numGrids == 1 && "Initialize dsgu first with initCombinedUniDSGVector()");
@@ -177,7 +234,8 @@ inline void SparseGridWorker::collectReduceDistribute(CombinationVariant combina
         }
         // global reduce (across process groups)
         CombiCom::distributedGlobalSubspaceReduce<DistributedSparseGridUniform<CombiDataType>,
-                                                  true>(*dsg, maxMiBToSendPerThread);
+                                                  true>(*dsg, maxMiBToSendPerThread,
+                                                        MPI_PROC_NULL, reproducibleReduce);
         // assert(CombiCom::sumAndCheckSubspaceSizes(*dsg)); // todo adapt for allocated spaces
         if constexpr (keepValuesInExtraSparseGrid) {
           this->copyFromPartialDsgToExtraDSG(g);
@@ -323,7 +381,12 @@ inline void SparseGridWorker::distributeChunkedBroadcasts(uint32_t maxMiBToSendP
       else {
         // non-output ranks need to wait before they can extract
         if (roundNumber == 0) Stats::startEvent("wait 1st bcast");
-        auto returnedValue = MPI_Wait(&request, MPI_STATUS_IGNORE);
+        int returnedValue;
+        {
+          CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::broadcast);
+          CommunicationCounters::WaitTimer waitTimer(globalReduceComm, 0, 0);
+          returnedValue = MPI_Wait(&request, MPI_STATUS_IGNORE);
+        }
         if (roundNumber == 0) Stats::stopEvent("wait 1st bcast");
         assert(returnedValue == MPI_SUCCESS);
       }
@@ -334,6 +397,8 @@ inline void SparseGridWorker::distributeChunkedBroadcasts(uint32_t maxMiBToSendP
       }
       OUTPUT_GROUP_EXCLUSIVE_SECTION {
         // output ranks can wait later
+        CommunicationCounters::PhaseScope phaseScope(CommunicationPhase::broadcast);
+        CommunicationCounters::WaitTimer waitTimer(globalReduceComm, 0, 0);
         auto returnedValue = MPI_Wait(&request, MPI_STATUS_IGNORE);
         assert(returnedValue == MPI_SUCCESS);
       }
@@ -522,6 +587,9 @@ inline void SparseGridWorker::interpolateAndPlotOnLevel(
     // save dfg to file with MPI-IO
     if (endsWith(filename, ".vtk")) {
       dfg.writePlotFileVTK(filename.c_str());
+    } else if (endsWith(filename, ".xdmf")) {
+      // writes one binary file per grid, directly from each process's block
+      dfg.writeXdmfPlotFile(filename.substr(0, filename.size() - 5) + "_" + std::to_string(g));
     } else {
       std::string fn = filename;
       auto pos = fn.find(".");
@@ -534,6 +602,73 @@ inline void SparseGridWorker::interpolateAndPlotOnLevel(
   }
 }
 
+inline DistributedSparseGridEvaluator<CombiDataType> SparseGridWorker::getSparseGridEvaluator(
+    const LevelVector& lmax, const std::vector<BoundaryType>& boundary,
+    const std::vector<bool>& hierarchizationDims,
+    const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+    const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+    bool forwardDecomposition) const {
+  for (DimType d = 0; d < static_cast<DimType>(lmax.size()); ++d) {
+    if (!hierarchizationDims[d] ||
+        (dynamic_cast<HierarchicalHatBasisFunction*>(hierarchicalBases[d]) == nullptr &&
+         dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(hierarchicalBases[d]) == nullptr)) {
+      throw std::runtime_error(
+          "sparse grid evaluation: only implemented for hat bases in all dimensions");
+    }
+  }
+  const auto& dsg = *this->getCombinedUniDSGVector()[0];
+  if (!dsg.isSubspaceDataCreated() ||
+      dsg.getCurrentlyAllocatedSubspaces().size() != dsg.getNumSubspaces()) {
+    throw std::runtime_error("sparse grid evaluation: sparse grid data not allocated");
+  }
+  // the same lmin as in fillDFGFromDSGU
+  bool anyNotBoundary =
+      std::any_of(boundary.cbegin(), boundary.cend(), [](BoundaryType b) { return b == 0; });
+  const LevelVector lminToUse = anyNotBoundary ? LevelVector(lmin.size(), 0) : lmin;
+
+  // only describes the partitioning, holds no data
+  DistributedFullGrid<CombiDataType> referenceGrid(
+      static_cast<DimType>(lmax.size()), lmax, theMPISystem()->getLocalComm(), boundary, nullptr,
+      parallelization, forwardDecomposition, decomposition);
+  return DistributedSparseGridEvaluator<CombiDataType>(dsg, referenceGrid, lminToUse);
+}
+
+inline std::vector<CombiDataType> SparseGridWorker::interpolateValuesOnSparseGrid(
+    const std::vector<std::vector<real>>& interpolationCoords, const LevelVector& lmax,
+    const std::vector<BoundaryType>& boundary, const std::vector<bool>& hierarchizationDims,
+    const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+    const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+    bool forwardDecomposition) const {
+  return this
+      ->getSparseGridEvaluator(lmax, boundary, hierarchizationDims, hierarchicalBases, lmin,
+                               parallelization, decomposition, forwardDecomposition)
+      .getInterpolatedValues(interpolationCoords);
+}
+
+inline void SparseGridWorker::writeSparseGridSliceXdmf(
+    const std::string& filenamePrefix, const std::vector<real>& sliceCoords,
+    const LevelVector& sliceLevel, const LevelVector& lmax,
+    const std::vector<BoundaryType>& boundary, const std::vector<bool>& hierarchizationDims,
+    const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+    const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+    bool forwardDecomposition) const {
+  this->getSparseGridEvaluator(lmax, boundary, hierarchizationDims, hierarchicalBases, lmin,
+                               parallelization, decomposition, forwardDecomposition)
+      .writeSliceXdmf(filenamePrefix, sliceCoords, sliceLevel);
+}
+
+inline std::vector<CombiDataType> SparseGridWorker::getProjectedValues(
+    const SparseGridProjection& projection, const LevelVector& lmax,
+    const std::vector<BoundaryType>& boundary, const std::vector<bool>& hierarchizationDims,
+    const std::vector<BasisFunctionBasis*>& hierarchicalBases, const LevelVector& lmin,
+    const std::vector<int>& parallelization, const std::vector<IndexVector>& decomposition,
+    bool forwardDecomposition) const {
+  return this
+      ->getSparseGridEvaluator(lmax, boundary, hierarchizationDims, hierarchicalBases, lmin,
+                               parallelization, decomposition, forwardDecomposition)
+      .getProjectedValues(projection, theMPISystem()->getMasterRank());
+}
+
 inline void SparseGridWorker::maxReduceSubspaceSizesInOutputGroup() {
   RankType globalReduceRankThatCollects = theMPISystem()->getOutputRankInGlobalReduceComm();
   CommunicatorType globalReduceComm = theMPISystem()->getGlobalReduceComm();
@@ -674,11 +809,13 @@ inline int SparseGridWorker::reduceExtraSubspaceSizes(const std::string& filenam
 
 inline void SparseGridWorker::reduceLocalAndGlobal(CombinationVariant combinationVariant,
                                                    uint32_t maxMiBToSendPerThread,
-                                                   RankType globalReduceRankThatCollects) {
+                                                   RankType globalReduceRankThatCollects,
+                                                   bool reproducibleReduce) {
   assert(this->getNumberOfGrids() > 0 &&
          "Initialize dsgu first with "
          "initCombinedUniDSGVector()");
   auto numGrids = this->getNumberOfGrids();
+  Stats::startEvent("local reduce");
   this->zeroDsgsData(combinationVariant);
   // local reduce (within rank)
   for (const auto& t : this->taskWorkerRef_.getTasks()) {
@@ -688,20 +825,25 @@ inline void SparseGridWorker::reduceLocalAndGlobal(CombinationVariant combinatio
       this->getCombinedUniDSGVector()[g]->addDistributedFullGrid(dfg, t->getCoefficient());
     }
   }
+  Stats::stopEvent("local reduce");
   // global reduce (across process groups)
+  Stats::startEvent("global reduce");
   for (int g = 0; g < numGrids; ++g) {
     if (combinationVariant == CombinationVariant::sparseGridReduce) {
       CombiCom::distributedGlobalSparseGridReduce(
-          *this->getCombinedUniDSGVector()[g], maxMiBToSendPerThread, globalReduceRankThatCollects);
+          *this->getCombinedUniDSGVector()[g], maxMiBToSendPerThread, globalReduceRankThatCollects,
+          theMPISystem()->getGlobalReduceComm(), reproducibleReduce);
     } else if (combinationVariant == CombinationVariant::subspaceReduce ||
                combinationVariant == CombinationVariant::outgroupSparseGridReduce) {
-      CombiCom::distributedGlobalSubspaceReduce(
-          *this->getCombinedUniDSGVector()[g], maxMiBToSendPerThread, globalReduceRankThatCollects);
+      CombiCom::distributedGlobalSubspaceReduce(*this->getCombinedUniDSGVector()[g],
+                                                maxMiBToSendPerThread,
+                                                globalReduceRankThatCollects, reproducibleReduce);
     } else {
       throw std::runtime_error("Combination variant not implemented");
     }
     assert(CombiCom::sumAndCheckSubspaceSizes(*this->getCombinedUniDSGVector()[g]));
   }
+  Stats::stopEvent("global reduce");
 }
 
 inline void SparseGridWorker::reduceSubspaceSizesBetweenGroups(
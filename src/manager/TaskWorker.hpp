@@ -26,6 +26,8 @@ class TaskWorker {
 
   inline std::vector<double> getLpNorms(int p) const;
 
+  inline std::vector<double> getAllLpNorms() const;
+
   inline const std::vector<std::unique_ptr<Task>>& getTasks() const;
 
   inline void hierarchizeFullGrids(const std::vector<BoundaryType>& boundary,
@@ -83,6 +85,17 @@ inline std::vector<double> TaskWorker::getLpNorms(int p) const {
   return lpnorms;
 }
 
+inline std::vector<double> TaskWorker::getAllLpNorms() const {
+  // get maximum, L1 and L2 norm of every task in one pass over each dfg, ordered by task
+  std::vector<double> lpnorms;
+  lpnorms.reserve(3 * this->getTasks().size());
+  for (const auto& t : this->getTasks()) {
+    auto taskNorms = t->getDistributedFullGrid().getLpNorms();
+    lpnorms.insert(lpnorms.end(), taskNorms.begin(), taskNorms.end());
+  }
+  return lpnorms;
+}
+
 inline const std::vector<std::unique_ptr<Task>>& TaskWorker::getTasks() const { return tasks_; }
 
 inline void TaskWorker::hierarchizeFullGrids(
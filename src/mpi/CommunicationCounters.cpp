@@ -0,0 +1,267 @@
+#include "mpi/CommunicationCounters.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "mpi/MPISystem.hpp"
+#include "utils/Stats.hpp"
+
+namespace combigrid {
+
+thread_local CommunicationPhase CommunicationCounters::currentPhase_ =
+    CommunicationPhase::unattributed;
+std::array<std::array<CommunicationCounters::AtomicCounter, CommunicationCounters::numKinds>,
+           CommunicationCounters::numPhases>
+    CommunicationCounters::stepCounters_;
+std::array<std::array<CommunicationCounters::Counter, CommunicationCounters::numKinds>,
+           CommunicationCounters::numPhases>
+    CommunicationCounters::totalCounters_;
+
+const std::string& CommunicationCounters::getPhaseName(CommunicationPhase phase) {
+  static const std::array<std::string, numPhases> names = {
+      "unattributed", "hierarchization", "dehierarchization",
+      "global reduce", "broadcast",      "third level"};
+  return names[static_cast<size_t>(phase)];
+}
+
+const std::string& CommunicationCounters::getCommunicatorKindName(CommunicatorKind kind) {
+  static const std::array<std::string, numKinds> names = {"local", "globalReduce", "outputGroup",
+                                                          "thirdLevel", "other"};
+  return names[static_cast<size_t>(kind)];
+}
+
+CommunicatorKind CommunicationCounters::getCommunicatorKind(CommunicatorType comm) {
+  if (comm == MPI_COMM_NULL || !theMPISystem()->isInitialized()) {
+    return CommunicatorKind::other;
+  }
+  if (comm == theMPISystem()->getLocalComm()) {
+    return CommunicatorKind::local;
+  }
+  if (comm == theMPISystem()->getGlobalReduceComm()) {
+    return CommunicatorKind::globalReduce;
+  }
+  if (comm == theMPISystem()->getOutputGroupComm()) {
+    return CommunicatorKind::outputGroup;
+  }
+  const auto& thirdLevelComms = theMPISystem()->getThirdLevelComms();
+  if (std::find(thirdLevelComms.cbegin(), thirdLevelComms.cend(), comm) !=
+      thirdLevelComms.cend()) {
+    return CommunicatorKind::thirdLevel;
+  }
+  return CommunicatorKind::other;
+}
+
+void CommunicationCounters::record(CommunicationPhase phase, CommunicatorKind kind,
+                                   uint64_t numMessages, uint64_t bytes, double waitSeconds) {
+  auto& counter = stepCounters_[static_cast<size_t>(phase)][static_cast<size_t>(kind)];
+  counter.numMessages.fetch_add(numMessages, std::memory_order_relaxed);
+  counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  counter.waitNanoseconds.fetch_add(static_cast<uint64_t>(waitSeconds * 1e9),
+                                    std::memory_order_relaxed);
+}
+
+CommunicationCounters::Counter CommunicationCounters::getStepCounter(CommunicationPhase phase,
+                                                                     CommunicatorKind kind) {
+  const auto& counter = stepCounters_[static_cast<size_t>(phase)][static_cast<size_t>(kind)];
+  Counter c;
+  c.numMessages = counter.numMessages.load(std::memory_order_relaxed);
+  c.bytes = counter.bytes.load(std::memory_order_relaxed);
+  c.waitSeconds =
+      static_cast<double>(counter.waitNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+  return c;
+}
+
+CommunicationCounters::Counter CommunicationCounters::getTotalCounter(CommunicationPhase phase,
+                                                                      CommunicatorKind kind) {
+  return totalCounters_[static_cast<size_t>(phase)][static_cast<size_t>(kind)];
+}
+
+std::string CommunicationCounters::getStepSummary() {
+  std::stringstream summary;
+  summary << std::setprecision(4);
+  bool first = true;
+  for (size_t p = 0; p < numPhases; ++p) {
+    for (size_t k = 0; k < numKinds; ++k) {
+      const auto phase = static_cast<CommunicationPhase>(p);
+      const auto kind = static_cast<CommunicatorKind>(k);
+      const auto c = getStepCounter(phase, kind);
+      if (c.numMessages == 0 && c.bytes == 0) continue;
+      if (!first) summary << "; ";
+      first = false;
+      summary << getPhaseName(phase) << "/" << getCommunicatorKindName(kind) << ": "
+              << c.numMessages << " msgs " << c.bytes << " B " << c.waitSeconds << " s";
+      if (c.waitSeconds > 0.) {
+        summary << " " << static_cast<double>(c.bytes) / 1048576. / c.waitSeconds << " MiB/s";
+      }
+    }
+  }
+  return summary.str();
+}
+
+void CommunicationCounters::finishStep(IndexType stepNumber) {
+  if (Stats::isInitialized()) {
+    Stats::setAttribute("communication step " + std::to_string(stepNumber), getStepSummary());
+  }
+  for (size_t p = 0; p < numPhases; ++p) {
+    for (size_t k = 0; k < numKinds; ++k) {
+      const auto c = getStepCounter(static_cast<CommunicationPhase>(p),
+                                    static_cast<CommunicatorKind>(k));
+      totalCounters_[p][k].numMessages += c.numMessages;
+      totalCounters_[p][k].bytes += c.bytes;
+      totalCounters_[p][k].waitSeconds += c.waitSeconds;
+      stepCounters_[p][k].numMessages.store(0, std::memory_order_relaxed);
+      stepCounters_[p][k].bytes.store(0, std::memory_order_relaxed);
+      stepCounters_[p][k].waitNanoseconds.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void CommunicationCounters::writeTotalsToStats() {
+  if (!Stats::isInitialized()) return;
+  for (size_t p = 0; p < numPhases; ++p) {
+    for (size_t k = 0; k < numKinds; ++k) {
+      const auto phase = static_cast<CommunicationPhase>(p);
+      const auto kind = static_cast<CommunicatorKind>(k);
+      const auto& c = totalCounters_[p][k];
+      if (c.numMessages == 0 && c.bytes == 0) continue;
+      Stats::setAttribute("communication " + getPhaseName(phase) + " " +
+                              getCommunicatorKindName(kind),
+                          std::to_string(c.numMessages) + " " + std::to_string(c.bytes) + " " +
+                              std::to_string(c.waitSeconds));
+    }
+  }
+}
+
+void CommunicationCounters::reset() {
+  for (size_t p = 0; p < numPhases; ++p) {
+    for (size_t k = 0; k < numKinds; ++k) {
+      stepCounters_[p][k].numMessages.store(0, std::memory_order_relaxed);
+      stepCounters_[p][k].bytes.store(0, std::memory_order_relaxed);
+      stepCounters_[p][k].waitNanoseconds.store(0, std::memory_order_relaxed);
+      totalCounters_[p][k] = Counter();
+    }
+  }
+}
+
+}  // namespace combigrid
+
+#ifdef DISCOTEC_PMPI_COUNTERS
+// interposition of MPI calls through the PMPI profiling interface;
+// only calls issued within a CommunicationCounters::PhaseScope are counted
+namespace {
+using combigrid::CommunicationCounters;
+using combigrid::CommunicationPhase;
+
+inline bool isCounting() {
+  return CommunicationCounters::getCurrentPhase() != CommunicationPhase::unattributed;
+}
+
+inline uint64_t getNumBytes(int count, MPI_Datatype datatype) {
+  int typeSize = 0;
+  PMPI_Type_size(datatype, &typeSize);
+  return static_cast<uint64_t>(count) * static_cast<uint64_t>(typeSize);
+}
+
+inline void count(MPI_Comm comm, uint64_t numMessages, uint64_t bytes,
+                  std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+  CommunicationCounters::record(CommunicationCounters::getCurrentPhase(),
+                                CommunicationCounters::getCommunicatorKind(comm), numMessages,
+                                bytes, waited.count());
+}
+}  // namespace
+
+extern "C" {
+
+int MPI_Send(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm) {
+  if (!isCounting()) return PMPI_Send(buf, count, datatype, dest, tag, comm);
+  auto start = std::chrono::steady_clock::now();
+  int result = PMPI_Send(buf, count, datatype, dest, tag, comm);
+  ::count(comm, 1, getNumBytes(count, datatype), start);
+  return result;
+}
+
+int MPI_Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+             MPI_Status* status) {
+  if (!isCounting()) return PMPI_Recv(buf, count, datatype, source, tag, comm, status);
+  auto start = std::chrono::steady_clock::now();
+  int result = PMPI_Recv(buf, count, datatype, source, tag, comm, status);
+  ::count(comm, 1, getNumBytes(count, datatype), start);
+  return result;
+}
+
+int MPI_Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm,
+              MPI_Request* request) {
+  if (isCounting()) {
+    CommunicationCounters::record(CommunicationCounters::getCurrentPhase(),
+                                  CommunicationCounters::getCommunicatorKind(comm), 1,
+                                  getNumBytes(count, datatype), 0.);
+  }
+  return PMPI_Isend(buf, count, datatype, dest, tag, comm, request);
+}
+
+int MPI_Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+              MPI_Request* request) {
+  if (isCounting()) {
+    CommunicationCounters::record(CommunicationCounters::getCurrentPhase(),
+                                  CommunicationCounters::getCommunicatorKind(comm), 1,
+                                  getNumBytes(count, datatype), 0.);
+  }
+  return PMPI_Irecv(buf, count, datatype, source, tag, comm, request);
+}
+
+int MPI_Allreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
+                  MPI_Comm comm) {
+  if (!isCounting()) return PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+  auto start = std::chrono::steady_clock::now();
+  int result = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+  ::count(comm, 1, getNumBytes(count, datatype), start);
+  return result;
+}
+
+int MPI_Reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
+               int root, MPI_Comm comm) {
+  if (!isCounting()) return PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+  auto start = std::chrono::steady_clock::now();
+  int result = PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+  ::count(comm, 1, getNumBytes(count, datatype), start);
+  return result;
+}
+
+int MPI_Bcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+  if (!isCounting()) return PMPI_Bcast(buffer, count, datatype, root, comm);
+  auto start = std::chrono::steady_clock::now();
+  int result = PMPI_Bcast(buffer, count, datatype, root, comm);
+  ::count(comm, 1, getNumBytes(count, datatype), start);
+  return result;
+}
+
+int MPI_Ibcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm,
+               MPI_Request* request) {
+  if (isCounting()) {
+    CommunicationCounters::record(CommunicationCounters::getCurrentPhase(),
+                                  CommunicationCounters::getCommunicatorKind(comm), 1,
+                                  getNumBytes(count, datatype), 0.);
+  }
+  return PMPI_Ibcast(buffer, count, datatype, root, comm, request);
+}
+
+int MPI_Wait(MPI_Request* request, MPI_Status* status) {
+  if (!isCounting()) return PMPI_Wait(request, status);
+  auto start = std::chrono::steady_clock::now();
+  int result = PMPI_Wait(request, status);
+  ::count(MPI_COMM_NULL, 0, 0, start);
+  return result;
+}
+
+int MPI_Waitall(int count, MPI_Request requests[], MPI_Status statuses[]) {
+  if (!isCounting()) return PMPI_Waitall(count, requests, statuses);
+  auto start = std::chrono::steady_clock::now();
+  int result = PMPI_Waitall(count, requests, statuses);
+  ::count(MPI_COMM_NULL, 0, 0, start);
+  return result;
+}
+
+}  // extern "C"
+#endif  // def DISCOTEC_PMPI_COUNTERS
@@ -0,0 +1,182 @@
+#ifndef COMMUNICATIONCOUNTERS_HPP_
+#define COMMUNICATIONCOUNTERS_HPP_
+
+// to resolve https://github.com/open-mpi/ompi/issues/5157
+#define OMPI_SKIP_MPICXX 1
+#include <mpi.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+#ifdef DISCOTEC_PMPI_COUNTERS
+constexpr bool usePMPICounters = true;
+#else
+constexpr bool usePMPICounters = false;
+#endif
+
+// if the communication routines report their volume through CommunicationCounters::add;
+// like Stats, this is only compiled in if TIMING is defined
+#if defined(TIMING) && !defined(DISCOTEC_PMPI_COUNTERS)
+constexpr bool countCommunicationExplicitly = true;
+#else
+constexpr bool countCommunicationExplicitly = false;
+#endif
+
+/** the phases of a combination step that communication volume is attributed to */
+enum class CommunicationPhase : uint8_t {
+  unattributed = 0,
+  hierarchization,
+  dehierarchization,
+  globalReduce,
+  broadcast,
+  thirdLevel,
+  numPhases
+};
+
+/** the communicators of the MPISystem that communication volume is attributed to */
+enum class CommunicatorKind : uint8_t {
+  local = 0,
+  globalReduce,
+  outputGroup,
+  thirdLevel,
+  other,
+  numCommunicatorKinds
+};
+
+/**
+ * @brief counts messages, bytes and waiting time per combination phase and communicator
+ *
+ * The current phase is set per thread with a CommunicationCounters::PhaseScope. By default, the
+ * communication routines of DisCoTec report their volume explicitly through add() if TIMING is
+ * defined. If built with DISCOTEC_PMPI_COUNTERS, the (blocking and non-blocking) point-to-point,
+ * reduction and broadcast MPI calls are intercepted through the PMPI profiling interface
+ * instead, and counted if they are issued within a phase; explicit calls to add() are ignored
+ * then to avoid double counting.
+ *
+ * The counters are accumulated per combination step; finishStep() publishes the step's counters
+ * as Stats attributes and adds them to the totals.
+ */
+class CommunicationCounters {
+ public:
+  struct Counter {
+    uint64_t numMessages = 0;
+    uint64_t bytes = 0;
+    double waitSeconds = 0.;
+  };
+
+  static const std::string& getPhaseName(CommunicationPhase phase);
+
+  static const std::string& getCommunicatorKindName(CommunicatorKind kind);
+
+  /** find out which of the MPISystem's communicators comm is */
+  static CommunicatorKind getCommunicatorKind(CommunicatorType comm);
+
+  static CommunicationPhase getCurrentPhase() { return currentPhase_; }
+
+  /**
+   * report communication in comm for the current phase of the calling thread;
+   * waitSeconds is the time spent blocking on completion of the communication
+   */
+  static void add(CommunicatorType comm, uint64_t numMessages, uint64_t bytes,
+                  double waitSeconds = 0.) {
+    if constexpr (countCommunicationExplicitly) {
+      record(currentPhase_, getCommunicatorKind(comm), numMessages, bytes, waitSeconds);
+    }
+  }
+
+  /** record communication, independent of the interposition mode; thread-safe */
+  static void record(CommunicationPhase phase, CommunicatorKind kind, uint64_t numMessages,
+                     uint64_t bytes, double waitSeconds);
+
+  /** counters for the current (not yet finished) step */
+  static Counter getStepCounter(CommunicationPhase phase, CommunicatorKind kind);
+
+  /** counters accumulated over all finished steps */
+  static Counter getTotalCounter(CommunicationPhase phase, CommunicatorKind kind);
+
+  /**
+   * summary of the current step's non-zero counters, in the format
+   * "<phase>/<communicator>: <messages> msgs <bytes> B <wait> s <bandwidth> MiB/s; ..."
+   */
+  static std::string getStepSummary();
+
+  /**
+   * close the current step: set its summary as Stats attribute
+   * "communication step <stepNumber>" (if Stats are initialized), add the step counters to the
+   * totals, and reset them
+   */
+  static void finishStep(IndexType stepNumber);
+
+  /**
+   * set Stats attributes "communication <phase> <communicator>" with the totals, as
+   * "<messages> <bytes> <wait seconds>"
+   */
+  static void writeTotalsToStats();
+
+  /** reset step and total counters */
+  static void reset();
+
+  /** RAII helper to attribute all communication of this thread to a phase */
+  class PhaseScope {
+   public:
+    explicit PhaseScope(CommunicationPhase phase) : previousPhase_(currentPhase_) {
+      currentPhase_ = phase;
+    }
+    ~PhaseScope() { currentPhase_ = previousPhase_; }
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+   private:
+    CommunicationPhase previousPhase_;
+  };
+
+  /** RAII helper to measure a blocking section and report it through add() */
+  class WaitTimer {
+   public:
+    WaitTimer(CommunicatorType comm, uint64_t numMessages, uint64_t bytes)
+        : comm_(comm), numMessages_(numMessages), bytes_(bytes) {
+      if constexpr (countCommunicationExplicitly) {
+        start_ = std::chrono::steady_clock::now();
+      }
+    }
+    ~WaitTimer() {
+      if constexpr (countCommunicationExplicitly) {
+        std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start_;
+        add(comm_, numMessages_, bytes_, waited.count());
+      }
+    }
+    WaitTimer(const WaitTimer&) = delete;
+    WaitTimer& operator=(const WaitTimer&) = delete;
+
+   private:
+    CommunicatorType comm_;
+    uint64_t numMessages_;
+    uint64_t bytes_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+ private:
+  static constexpr size_t numPhases = static_cast<size_t>(CommunicationPhase::numPhases);
+  static constexpr size_t numKinds = static_cast<size_t>(CommunicatorKind::numCommunicatorKinds);
+
+  struct AtomicCounter {
+    std::atomic<uint64_t> numMessages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> waitNanoseconds{0};
+  };
+
+  static thread_local CommunicationPhase currentPhase_;
+  static std::array<std::array<AtomicCounter, numKinds>, numPhases> stepCounters_;
+  static std::array<std::array<Counter, numKinds>, numPhases> totalCounters_;
+};
+
+}  // namespace combigrid
+
+#endif /* COMMUNICATIONCOUNTERS_HPP_ */
@@ -65,6 +65,44 @@ int get_all_memory_usage_kb(unsigned long* vmrss, unsigned long* vmsize, Communi
   return 0;
 }
 
+int get_memory_high_water_mark_kb(unsigned long* vmhwm_kb) {
+  FILE* procfile = fopen("/proc/self/status", "r");
+  if (procfile == NULL) {
+    return 1;
+  }
+  char line[256];
+  int found_vmhwm = 0;
+  while (found_vmhwm == 0 && fgets(line, sizeof(line), procfile) != NULL) {
+    if (strncmp(line, "VmHWM:", 6) == 0) {
+      found_vmhwm = sscanf(line, "%*s %lu", vmhwm_kb);
+    }
+  }
+  fclose(procfile);
+  return found_vmhwm == 1 ? 0 : 1;
+}
+
+int get_all_memory_high_water_mark_kb(unsigned long* max_vmhwm, unsigned long* sum_vmhwm,
+                                      CommunicatorType comm) {
+  unsigned long vmhwm = 0;
+  int ret_code = get_memory_high_water_mark_kb(&vmhwm);
+  if (ret_code != 0) {
+    printf("Could not gather memory high water mark!\n");
+  }
+  MPI_Allreduce(&vmhwm, max_vmhwm, 1, MPI_UNSIGNED_LONG, MPI_MAX, comm);
+  MPI_Allreduce(&vmhwm, sum_vmhwm, 1, MPI_UNSIGNED_LONG, MPI_SUM, comm);
+  return ret_code;
+}
+
+int reset_memory_high_water_mark() {
+  // cf. https://www.kernel.org/doc/html/latest/filesystems/proc.html, "clear_refs"
+  FILE* clearRefs = fopen("/proc/self/clear_refs", "w");
+  if (clearRefs == NULL) {
+    return 1;
+  }
+  int written = fputs("5", clearRefs);
+  return (fclose(clearRefs) == 0 && written >= 0) ? 0 : 1;
+}
+
 int get_memory_usage_local_kb(unsigned long* local_vmrss, unsigned long* local_vmsize) {
   return get_all_memory_usage_kb(local_vmrss, local_vmsize, theMPISystem()->getLocalComm());
 }
@@ -26,6 +26,24 @@ int get_all_memory_usage_kb(unsigned long* vmrss, unsigned long* vmsize, Communi
 
 int get_memory_usage_local_kb(unsigned long* local_vmrss, unsigned long* local_vmsize);
 
+/**
+ * @brief the peak resident set size (VmHWM) of this process since its start or the last
+ * reset_memory_high_water_mark
+ */
+int get_memory_high_water_mark_kb(unsigned long* vmhwm_kb);
+
+/**
+ * @brief the maximum and sum of the peak resident set sizes of all processes in comm
+ */
+int get_all_memory_high_water_mark_kb(unsigned long* max_vmhwm, unsigned long* sum_vmhwm,
+                                      CommunicatorType comm);
+
+/**
+ * @brief resets the peak resident set size of this process to the current one
+ * (only on Linux >= 4.0; returns 1 if not possible)
+ */
+int reset_memory_high_water_mark();
+
 void print_memory_usage_local();
 
 void print_memory_usage_world();
@@ -0,0 +1,565 @@
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "io/XdmfOutput.hpp"
+#include "mpi/MPIUtils.hpp"
+#include "sparsegrid/DistributedSparseGridUniform.hpp"
+#include "sparsegrid/SparseGridProjection.hpp"
+#include "utils/PowerOfTwo.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief evaluates the (hat-basis) hierarchical surpluses stored in a DistributedSparseGridUniform
+ * directly, without extracting them into a full grid first
+ *
+ * For each point, only the basis functions that have support there are visited: one per
+ * subspace for the levels > 1 (and up to three for the level-1 subspaces with boundary). Each
+ * process evaluates the subspace points it owns; the partial values are summed over the
+ * sparse grid's communicator.
+ *
+ * The ownership of subspace points is taken from a reference full grid, which needs to have the
+ * same domain decomposition as the grids that were registered in the sparse grid, and levels at
+ * least as large as every subspace. The reference grid's data is never accessed, so it can be
+ * created without any.
+ *
+ * The sparse grid only needs to hold data for the evaluation of its own surpluses; surpluses that
+ * are streamed from elsewhere (cf. addSubspacePartValues) only require its subspace sizes.
+ */
+template <typename FG_ELEMENT>
+class DistributedSparseGridEvaluator {
+ public:
+  /**
+   * @param dsg the sparse grid holding the hierarchical surpluses
+   * @param referenceGrid full grid that describes this process's partition of the domain
+   * @param lmin the minimum level of the hierarchization, the surpluses of levels <= lmin are
+   * nodal values on level lmin (cf. DistributedHierarchization::dehierarchizeDFG)
+   */
+  DistributedSparseGridEvaluator(const DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                                 const DistributedFullGrid<FG_ELEMENT>& referenceGrid,
+                                 const LevelVector& lmin)
+      : dsg_(dsg),
+        boundary_(referenceGrid.returnBoundaryFlags()),
+        lmin_(lmin),
+        referenceLevels_(referenceGrid.getLevels()),
+        firstGlobalIndex_(dsg.getDim()),
+        localSize_(dsg.getDim()),
+        strides_(dsg.getDim()),
+        localStarts_(dsg.getDim()),
+        numPoints_(dsg.getDim()) {
+    assert(referenceGrid.getDimension() == dsg_.getDim());
+    assert(lmin_.size() == dsg_.getDim());
+    for (DimType d = 0; d < dsg_.getDim(); ++d) {
+      firstGlobalIndex_[d] = referenceGrid.getFirstGlobal1dIndex(d);
+      localSize_[d] = referenceGrid.getLocalSizes()[d];
+      // index 0 is unused, levels start at 1
+      strides_[d].resize(referenceLevels_[d] + 1, 0);
+      localStarts_[d].resize(referenceLevels_[d] + 1, 0);
+      numPoints_[d].resize(referenceLevels_[d] + 1, 0);
+      for (LevelType l = 1; l <= referenceLevels_[d]; ++l) {
+        strides_[d][l] = referenceGrid.getStrideForThisLevel(l, d);
+        localStarts_[d][l] = referenceGrid.getLocalStartForThisLevel(l, d, strides_[d][l]);
+        numPoints_[d][l] =
+            referenceGrid.getNumPointsOnThisPartition(d, localStarts_[d][l], strides_[d][l]);
+      }
+    }
+#ifndef NDEBUG
+    for (typename AnyDistributedSparseGrid::SubspaceIndexType s = 0; s < dsg_.getNumSubspaces();
+         ++s) {
+      const auto& level = dsg_.getLevelVector(s);
+      IndexType numPointsOfSubspace = 1;
+      for (DimType d = 0; d < dsg_.getDim(); ++d) {
+        assert(level[d] <= referenceLevels_[d]);
+        numPointsOfSubspace *= numPoints_[d][level[d]];
+      }
+      assert(dsg_.getDataSize(s) == 0 ||
+             static_cast<IndexType>(dsg_.getDataSize(s)) == numPointsOfSubspace);
+    }
+#endif  // ndef NDEBUG
+  }
+
+  /**
+   * @brief evaluates the sparse grid function on the specified coordinates
+   *
+   * collective on the sparse grid's communicator, all processes get all values
+   *
+   * @param interpolationCoords vector of ND coordinates on the unit square [0,1]^D
+   */
+  std::vector<FG_ELEMENT> getInterpolatedValues(
+      const std::vector<std::vector<real>>& interpolationCoords) const {
+    auto numValues = interpolationCoords.size();
+    std::vector<FG_ELEMENT> values(numValues);
+#pragma omp parallel for default(none) firstprivate(numValues) \
+    shared(values, interpolationCoords) schedule(static)
+    for (size_t i = 0; i < numValues; ++i) {
+      values[i] = this->evalLocal(interpolationCoords[i]);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numValues),
+                  abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>()),
+                  MPI_SUM, dsg_.getCommunicator());
+    return values;
+  }
+
+  /**
+   * @brief evaluates the contribution of this process's subspace points at coords
+   *
+   * @param coords ND coordinates on the unit square [0,1]^D
+   */
+  FG_ELEMENT evalLocal(const std::vector<real>& coords) const {
+    assert(dsg_.isSubspaceDataCreated());
+    const DimType dim = dsg_.getDim();
+    assert(coords.size() == dim);
+    // the local 1d positions and basis function values of the points that have support at
+    // coords, per dimension and level
+    static thread_local std::vector<std::vector<std::vector<Support>>> supports;
+    supports.resize(dim);
+    for (DimType d = 0; d < dim; ++d) {
+      assert(coords[d] >= 0. && coords[d] <= 1.);
+      supports[d].resize(referenceLevels_[d] + 1);
+      for (LevelType l = 1; l <= referenceLevels_[d]; ++l) {
+        getSupports(coords[d], d, l, supports[d][l]);
+      }
+    }
+
+    FG_ELEMENT result = 0.;
+    for (typename AnyDistributedSparseGrid::SubspaceIndexType s = 0; s < dsg_.getNumSubspaces();
+         ++s) {
+      if (dsg_.getAllocatedDataSize(s) == 0) continue;
+      const auto& level = dsg_.getLevelVector(s);
+      bool hasSupport = true;
+      for (DimType d = 0; d < dim; ++d) {
+        if (supports[d][level[d]].empty()) {
+          hasSupport = false;
+          break;
+        }
+      }
+      if (!hasSupport) continue;
+      result += evalSubspaceRecursive(supports, level, dsg_.getData(s), 0,
+                                      static_cast<IndexType>(dsg_.getDataSize(s)),
+                                      static_cast<DimType>(dim - 1), 0, 1.);
+    }
+    return result;
+  }
+
+  /**
+   * @brief adds the contribution of this process's points [first, first + numValues) of subspace
+   * s, with the surpluses partValues, to the function values at interpolationCoords
+   *
+   * for surpluses that are not stored in the sparse grid, e.g. when streaming them from a file
+   * (cf. DistributedSparseGridIO::readFilesChunked); not collective
+   *
+   * @param values [IN/OUT] one value per coordinate
+   */
+  void addSubspacePartValues(typename AnyDistributedSparseGrid::SubspaceIndexType s,
+                             IndexType first, IndexType numValues, const FG_ELEMENT* partValues,
+                             const std::vector<std::vector<real>>& interpolationCoords,
+                             std::vector<FG_ELEMENT>& values) const {
+    const DimType dim = dsg_.getDim();
+    const auto& level = dsg_.getLevelVector(s);
+    assert(first + numValues <= static_cast<IndexType>(dsg_.getDataSize(s)));
+    assert(values.size() == interpolationCoords.size());
+    const auto numCoords = interpolationCoords.size();
+#pragma omp parallel for default(none) firstprivate(dim, first, numValues, numCoords, partValues) \
+    shared(level, values, interpolationCoords) schedule(static)
+    for (size_t i = 0; i < numCoords; ++i) {
+      // only the supports on the subspace's level are needed, the others stay empty
+      static thread_local std::vector<std::vector<std::vector<Support>>> supports;
+      supports.resize(dim);
+      bool hasSupport = true;
+      for (DimType d = 0; d < dim && hasSupport; ++d) {
+        assert(interpolationCoords[i][d] >= 0. && interpolationCoords[i][d] <= 1.);
+        supports[d].resize(referenceLevels_[d] + 1);
+        this->getSupports(interpolationCoords[i][d], d, level[d], supports[d][level[d]]);
+        hasSupport = !supports[d][level[d]].empty();
+      }
+      if (!hasSupport) continue;
+      values[i] += this->evalSubspaceRecursive(supports, level, partValues, first, numValues,
+                                               static_cast<DimType>(dim - 1), 0, 1.);
+    }
+  }
+
+  /**
+   * @brief the integrals over [0,1]^D of the basis functions of this process's points
+   * [first, first + numValues) of subspace s
+   */
+  void getBasisIntegrals(typename AnyDistributedSparseGrid::SubspaceIndexType s, IndexType first,
+                         IndexType numValues, std::vector<real>& integrals) const {
+    integrals.resize(numValues);
+    if (numValues == 0) return;
+    const DimType dim = dsg_.getDim();
+    const auto& level = dsg_.getLevelVector(s);
+    std::vector<std::vector<real>> integrals1d(dim);
+    IndexVector position(dim);
+    auto remainder = first;
+    for (DimType d = 0; d < dim; ++d) {
+      getIntegrals(d, level[d], integrals1d[d]);
+      position[d] = remainder % numPoints_[d][level[d]];
+      remainder /= numPoints_[d][level[d]];
+    }
+    for (IndexType i = 0; i < numValues; ++i) {
+      real integral = 1.;
+      for (DimType d = 0; d < dim; ++d) {
+        integral *= integrals1d[d][position[d]];
+      }
+      integrals[i] = integral;
+      // advance the position, the first dimension runs fastest
+      for (DimType d = 0; d < dim; ++d) {
+        if (++position[d] < numPoints_[d][level[d]]) break;
+        position[d] = 0;
+      }
+    }
+  }
+
+  /**
+   * @brief writes the sparse grid function on a uniform grid of up to three dimensions, e.g. a
+   * (downsampled) slice through the domain, without creating a full grid of the sparse grid's
+   * levels
+   *
+   * collective on the sparse grid's communicator; the points are evaluated in chunks, and each
+   * process receives and writes one contiguous part of every chunk
+   *
+   * @param filenamePrefix the files filenamePrefix.bin and filenamePrefix.xdmf are written
+   * @param sliceCoords per dimension, the coordinate of the slice, or NaN if the dimension is kept
+   * @param sliceLevel per dimension, the level of the output grid (2^l + 1 points including the
+   * boundary), only used for the kept dimensions
+   * @param chunkSize the number of points that are evaluated at once
+   */
+  void writeSliceXdmf(const std::string& filenamePrefix, const std::vector<real>& sliceCoords,
+                      const LevelVector& sliceLevel, size_t chunkSize = 65536) const {
+    const DimType dim = dsg_.getDim();
+    assert(sliceCoords.size() == dim && sliceLevel.size() == dim);
+    std::vector<DimType> keptDims;
+    IndexVector extents;
+    std::vector<real> spacing;
+    for (DimType d = 0; d < dim; ++d) {
+      if (std::isnan(sliceCoords[d])) {
+        keptDims.push_back(d);
+        extents.push_back(powerOfTwoByBitshift(sliceLevel[d]) + 1);
+        spacing.push_back(oneOverPowOfTwo[sliceLevel[d]]);
+      } else {
+        assert(sliceCoords[d] >= 0. && sliceCoords[d] <= 1.);
+      }
+    }
+    if (keptDims.empty() || keptDims.size() > 3) {
+      throw std::runtime_error("writeSliceXdmf: XDMF output only supports 1 to 3 dimensions");
+    }
+    const auto numPoints = static_cast<size_t>(
+        std::accumulate(extents.begin(), extents.end(), IndexType(1), std::multiplies<IndexType>()));
+
+    const auto comm = dsg_.getCommunicator();
+    int size, rank;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+    const auto dataType =
+        abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
+    const std::string binaryFileName = filenamePrefix + ".bin";
+    MPI_File fh;
+    MPI_File_open(comm, binaryFileName.c_str(), MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
+                  &fh);
+    MPI_File_set_size(fh, 0);
+
+    std::vector<FG_ELEMENT> chunkValues;
+    std::vector<FG_ELEMENT> myValues;
+    std::vector<int> recvCounts(size);
+    for (size_t chunkStart = 0; chunkStart < numPoints; chunkStart += chunkSize) {
+      const auto numChunkPoints = std::min(chunkSize, numPoints - chunkStart);
+      chunkValues.resize(numChunkPoints);
+#pragma omp parallel for default(none) firstprivate(chunkStart, numChunkPoints) \
+    shared(chunkValues, keptDims, extents, spacing, sliceCoords) schedule(static)
+      for (size_t i = 0; i < numChunkPoints; ++i) {
+        std::vector<real> coords(sliceCoords);
+        auto linearIndex = static_cast<IndexType>(chunkStart + i);
+        for (size_t k = 0; k < keptDims.size(); ++k) {
+          coords[keptDims[k]] = static_cast<real>(linearIndex % extents[k]) * spacing[k];
+          linearIndex /= extents[k];
+        }
+        chunkValues[i] = this->evalLocal(coords);
+      }
+      // every process gets the sum for its contiguous part of the chunk
+      size_t myOffset = chunkStart;
+      for (int r = 0; r < size; ++r) {
+        recvCounts[r] = static_cast<int>(numChunkPoints / size +
+                                         (static_cast<size_t>(r) < numChunkPoints % size ? 1 : 0));
+        if (r < rank) myOffset += recvCounts[r];
+      }
+      myValues.resize(recvCounts[rank]);
+      MPI_Reduce_scatter(chunkValues.data(), myValues.data(), recvCounts.data(), dataType, MPI_SUM,
+                         comm);
+      MPI_File_write_at_all(fh, static_cast<MPI_Offset>(myOffset * sizeof(FG_ELEMENT)),
+                            myValues.data(), recvCounts[rank], dataType, MPI_STATUS_IGNORE);
+    }
+    MPI_File_close(&fh);
+
+    if (rank == 0) {
+      xdmfio::writeXdmfDescriptor<FG_ELEMENT>(filenamePrefix + ".xdmf",
+                                              xdmfio::getBaseName(binaryFileName), extents,
+                                              std::vector<real>(keptDims.size(), 0.), spacing);
+    }
+  }
+
+  /**
+   * @brief evaluates a lower-dimensional projection (slices and marginals) of the sparse grid
+   * function on a uniform grid in the kept dimensions, cf. SparseGridProjection
+   *
+   * Since the basis functions factorize per dimension, each subspace's surpluses are first
+   * contracted with the basis function values at the slice coordinates resp. the basis function
+   * integrals in the dimensions that are not kept. Only the contracted subspaces are evaluated on
+   * the output grid. Collective on the sparse grid's communicator.
+   *
+   * @param root the rank (in the sparse grid's communicator) that gets the summed values
+   * @return the values on the output grid, with the first kept dimension running fastest; only
+   * on root, the other processes get their partial values
+   */
+  std::vector<FG_ELEMENT> getProjectedValues(const SparseGridProjection& projection,
+                                             RankType root = 0) const {
+    const DimType dim = dsg_.getDim();
+    assert(dsg_.isSubspaceDataCreated());
+    assert(projection.sliceCoords.size() == dim && projection.integratedDims.size() == dim &&
+           projection.outputLevel.size() == dim);
+    std::vector<DimType> keptDims;
+    IndexVector extents;
+    // per dimension and level: the weights of this process's points in the contracted dimensions
+    std::vector<std::vector<std::vector<real>>> weights(dim);
+    std::vector<Support> supports;
+    for (DimType d = 0; d < dim; ++d) {
+      if (projection.isKept(d)) {
+        keptDims.push_back(d);
+        extents.push_back(powerOfTwoByBitshift(projection.outputLevel[d]) + 1);
+        continue;
+      }
+      assert(!projection.integratedDims[d] || std::isnan(projection.sliceCoords[d]));
+      weights[d].resize(referenceLevels_[d] + 1);
+      for (LevelType l = 1; l <= referenceLevels_[d]; ++l) {
+        if (projection.integratedDims[d]) {
+          getIntegrals(d, l, weights[d][l]);
+        } else {
+          assert(projection.sliceCoords[d] >= 0. && projection.sliceCoords[d] <= 1.);
+          weights[d][l].assign(numPoints_[d][l], 0.);
+          getSupports(projection.sliceCoords[d], d, l, supports);
+          for (const auto& support : supports) {
+            weights[d][l][support.position] = support.phi;
+          }
+        }
+      }
+    }
+
+    // contract the subspaces in all dimensions that are not kept
+    const auto numSubspaces = dsg_.getNumSubspaces();
+    std::vector<std::vector<FG_ELEMENT>> contracted(numSubspaces);
+#pragma omp parallel for default(none) firstprivate(dim, numSubspaces) \
+    shared(contracted, weights, keptDims) schedule(dynamic)
+    for (typename AnyDistributedSparseGrid::SubspaceIndexType s = 0; s < numSubspaces; ++s) {
+      const auto numValues = dsg_.getAllocatedDataSize(s);
+      if (numValues == 0) continue;
+      const auto& level = dsg_.getLevelVector(s);
+      IndexType contractedSize = 1;
+      for (const auto& d : keptDims) contractedSize *= numPoints_[d][level[d]];
+      contracted[s].assign(contractedSize, 0.);
+      const FG_ELEMENT* data = dsg_.getData(s);
+      IndexVector position(dim, 0);
+      for (size_t i = 0; i < numValues; ++i) {
+        real weight = 1.;
+        IndexType contractedIndex = 0;
+        for (DimType d = dim; d-- > 0;) {
+          if (weights[d].empty()) {
+            contractedIndex = contractedIndex * numPoints_[d][level[d]] + position[d];
+          } else {
+            weight *= weights[d][level[d]][position[d]];
+          }
+        }
+        if (weight != 0.) {
+          contracted[s][contractedIndex] += weight * data[i];
+        }
+        // advance the position, the first dimension runs fastest
+        for (DimType d = 0; d < dim; ++d) {
+          if (++position[d] < numPoints_[d][level[d]]) break;
+          position[d] = 0;
+        }
+      }
+    }
+
+    // evaluate the contracted subspaces on the output grid
+    const auto numPoints = static_cast<size_t>(
+        std::accumulate(extents.begin(), extents.end(), IndexType(1), std::multiplies<IndexType>()));
+    std::vector<FG_ELEMENT> values(numPoints);
+#pragma omp parallel for default(none) firstprivate(numPoints, numSubspaces) \
+    shared(values, contracted, keptDims, extents, projection) schedule(static)
+    for (size_t i = 0; i < numPoints; ++i) {
+      static thread_local std::vector<std::vector<std::vector<Support>>> keptSupports;
+      keptSupports.resize(keptDims.size());
+      auto linearIndex = static_cast<IndexType>(i);
+      for (size_t k = 0; k < keptDims.size(); ++k) {
+        const auto d = keptDims[k];
+        const real coord = static_cast<real>(linearIndex % extents[k]) *
+                           oneOverPowOfTwo[projection.outputLevel[d]];
+        linearIndex /= extents[k];
+        keptSupports[k].resize(referenceLevels_[d] + 1);
+        for (LevelType l = 1; l <= referenceLevels_[d]; ++l) {
+          getSupports(coord, d, l, keptSupports[k][l]);
+        }
+      }
+      FG_ELEMENT result = 0.;
+      for (typename AnyDistributedSparseGrid::SubspaceIndexType s = 0; s < numSubspaces; ++s) {
+        if (contracted[s].empty()) continue;
+        result += evalContractedRecursive(keptSupports, keptDims, dsg_.getLevelVector(s),
+                                          contracted[s].data(), keptDims.size(), 0, 1.);
+      }
+      values[i] = result;
+    }
+
+    const auto dataType =
+        abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
+    int rank;
+    MPI_Comm_rank(dsg_.getCommunicator(), &rank);
+    MPI_Reduce(rank == root ? MPI_IN_PLACE : values.data(), values.data(),
+               static_cast<int>(numPoints), dataType, MPI_SUM, root, dsg_.getCommunicator());
+    return values;
+  }
+
+ private:
+  struct Support {
+    IndexType position;  // the position among this process's points of the level
+    real phi;            // the basis function's value
+  };
+
+  /**
+   * @brief adds the point with global index globalIndex (on the reference grid) to supports if
+   * it is on this process
+   */
+  inline void addSupportIfLocal(DimType d, LevelType l, IndexType globalIndex, real phi,
+                                std::vector<Support>& supports) const {
+    if (!(phi > 0.)) return;
+    const auto localIndex = globalIndex - firstGlobalIndex_[d];
+    if (localIndex < localStarts_[d][l] || localIndex >= localSize_[d]) return;
+    assert((localIndex - localStarts_[d][l]) % strides_[d][l] == 0);
+    const auto position = (localIndex - localStarts_[d][l]) / strides_[d][l];
+    assert(position < numPoints_[d][l]);
+    supports.push_back({position, phi});
+  }
+
+  /**
+   * @brief collects the hat functions of level l in dimension d that have support at coord
+   */
+  inline void getSupports(real coord, DimType d, LevelType l, std::vector<Support>& supports) const {
+    supports.clear();
+    if (numPoints_[d][l] == 0) return;
+    const auto referenceLevel = referenceLevels_[d];
+    // the levels <= lmin are nodal on lmin
+    const real width = oneOverPowOfTwo[std::max(l, lmin_[d])];
+    // the first point is at index 0 on grids with boundary, otherwise the first index is at h
+    const IndexType boundaryShift = boundary_[d] > 0 ? 0 : 1;
+    // the (only) point of this level that can have support at coord
+    auto indexOnLevel =
+        2 * static_cast<IndexType>(coord * static_cast<real>(powerOfTwo[l - 1])) + 1;
+    indexOnLevel = std::min(indexOnLevel, powerOfTwoByBitshift(l) - 1);
+    const real pointCoord = static_cast<real>(indexOnLevel) * oneOverPowOfTwo[l];
+    addSupportIfLocal(d, l, (indexOnLevel << (referenceLevel - l)) - boundaryShift,
+                      1. - std::abs(coord - pointCoord) / width, supports);
+    if (l == 1 && boundary_[d] > 0) {
+      // the boundary points also belong to the level-1 subspace, with (level-0) hat functions of
+      // width one
+      const real boundaryWidth = oneOverPowOfTwo[lmin_[d]];
+      const real phiLower = std::max(0., 1. - coord / boundaryWidth);
+      const real phiUpper = std::max(0., 1. - (1. - coord) / boundaryWidth);
+      if (boundary_[d] == 2) {
+        addSupportIfLocal(d, l, 0, phiLower, supports);
+        addSupportIfLocal(d, l, powerOfTwoByBitshift(referenceLevel), phiUpper, supports);
+      } else {
+        // periodic: the upper boundary point is the lower one
+        addSupportIfLocal(d, l, 0, phiLower + phiUpper, supports);
+      }
+    }
+  }
+
+  /**
+   * @brief sums up the tensor products of the supports in dimensions 0..d, the subspace data is
+   * stored with the first dimension running fastest (cf.
+   * DistributedFullGrid::getFGPointsOfSubspace)
+   *
+   * subspaceData holds the subspace's points [first, first + numValues), the others are skipped
+   */
+  FG_ELEMENT evalSubspaceRecursive(const std::vector<std::vector<std::vector<Support>>>& supports,
+                                   const LevelVector& level, const FG_ELEMENT* subspaceData,
+                                   IndexType first, IndexType numValues, DimType d,
+                                   IndexType linearIndex, real phi) const {
+    FG_ELEMENT result = 0.;
+    for (const auto& support : supports[d][level[d]]) {
+      const auto updatedLinearIndex = linearIndex * numPoints_[d][level[d]] + support.position;
+      if (d > 0) {
+        result += evalSubspaceRecursive(supports, level, subspaceData, first, numValues,
+                                        static_cast<DimType>(d - 1), updatedLinearIndex,
+                                        phi * support.phi);
+      } else if (updatedLinearIndex >= first && updatedLinearIndex < first + numValues) {
+        result += phi * support.phi * subspaceData[updatedLinearIndex - first];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief the integrals over [0,1] of the basis functions of this process's points of level l in
+   * dimension d
+   */
+  inline void getIntegrals(DimType d, LevelType l, std::vector<real>& integrals) const {
+    // the levels <= lmin are nodal on lmin
+    integrals.assign(numPoints_[d][l], oneOverPowOfTwo[std::max(l, lmin_[d])]);
+    if (l == 1 && boundary_[d] > 0) {
+      // the boundary points' (level-0) hat functions have width one on lmin, only half of
+      // it inside the domain -- unless periodic, where both halves belong to the same point
+      const real boundaryIntegral = oneOverPowOfTwo[lmin_[d]] * (boundary_[d] == 2 ? 0.5 : 1.);
+      const auto lastGlobalIndex = powerOfTwoByBitshift(referenceLevels_[d]);
+      for (IndexType position = 0; position < numPoints_[d][l]; ++position) {
+        const auto globalIndex =
+            firstGlobalIndex_[d] + localStarts_[d][l] + position * strides_[d][l];
+        if (globalIndex == 0 || (boundary_[d] == 2 && globalIndex == lastGlobalIndex)) {
+          integrals[position] = boundaryIntegral;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief like evalSubspaceRecursive, for a subspace that is contracted to the kept dimensions
+   * keptDims[0..k)
+   */
+  FG_ELEMENT evalContractedRecursive(
+      const std::vector<std::vector<std::vector<Support>>>& keptSupports,
+      const std::vector<DimType>& keptDims, const LevelVector& level,
+      const FG_ELEMENT* contractedData, size_t k, IndexType linearIndex, real phi) const {
+    if (k == 0) {
+      return phi * contractedData[linearIndex];
+    }
+    const auto d = keptDims[k - 1];
+    FG_ELEMENT result = 0.;
+    for (const auto& support : keptSupports[k - 1][level[d]]) {
+      result += evalContractedRecursive(keptSupports, keptDims, level, contractedData, k - 1,
+                                        linearIndex * numPoints_[d][level[d]] + support.position,
+                                        phi * support.phi);
+    }
+    return result;
+  }
+
+  const DistributedSparseGridUniform<FG_ELEMENT>& dsg_;
+  const std::vector<BoundaryType> boundary_;
+  const LevelVector lmin_;
+  const LevelVector referenceLevels_;
+
+  // per dimension: first global index and number of points on this process
+  std::vector<IndexType> firstGlobalIndex_;
+  std::vector<IndexType> localSize_;
+  // per dimension and level: the local index stride, first local index and number of points on
+  // this process
+  std::vector<IndexVector> strides_;
+  std::vector<IndexVector> localStarts_;
+  std::vector<IndexVector> numPoints_;
+};
+
+}  // namespace combigrid
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <fstream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "io/MPIInputOutput.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
+#include "utils/LevelVector.hpp"
 #include "utils/Types.hpp"
 
 namespace combigrid {
@@ -118,6 +125,262 @@ int readOneFileAndReduce(SparseGridType& dsg, const std::string& fileName,
   return numReduced;
 }
 
+/**
+ * @brief streams sparse grid files (as written by writeOneFile for sparse grids with the
+ * subspace sizes of dsg) in chunks, without allocating the sparse grid's data
+ *
+ * collective on dsg's communicator; processSubspacePart is called once for every overlap of a
+ * subspace and a chunk as processSubspacePart(subspaceIndex, firstIndexInSubspace, numValues,
+ * values), where values[f] points to the subspace part's values in fileNames[f]
+ *
+ * @param numElementsToBuffer the chunk size, e.g. from CombiCom::getGlobalReduceChunkSize
+ *
+ * @return the number of values read per file
+ */
+template <typename SparseGridType, typename SubspacePartFunctionType>
+MPI_Offset readFilesChunked(const SparseGridType& dsg, const std::vector<std::string>& fileNames,
+                            int numElementsToBuffer, SubspacePartFunctionType processSubspacePart) {
+  using ElementType = typename SparseGridType::ElementType;
+  using SubspaceIndexType = typename SparseGridType::SubspaceIndexType;
+  const auto& subspaceSizes = dsg.getSubspaceDataSizes();
+  const MPI_Offset len =
+      std::accumulate(subspaceSizes.begin(), subspaceSizes.end(), static_cast<MPI_Offset>(0));
+  // the subspace and position within it where the next chunk starts
+  SubspaceIndexType subspaceIndex = 0;
+  SubspaceSizeType indexInSubspace = 0;
+  std::vector<const ElementType*> values(fileNames.size());
+  auto processChunk = [&](MPI_Offset, int numValuesInChunk,
+                          const std::vector<std::vector<ElementType>>& buffers) {
+    SubspaceSizeType chunkPosition = 0;
+    while (chunkPosition < static_cast<SubspaceSizeType>(numValuesInChunk)) {
+      assert(static_cast<size_t>(subspaceIndex) < subspaceSizes.size());
+      const auto numValues = std::min(subspaceSizes[subspaceIndex] - indexInSubspace,
+                                      numValuesInChunk - chunkPosition);
+      if (numValues > 0) {
+        for (size_t f = 0; f < buffers.size(); ++f) {
+          values[f] = buffers[f].data() + chunkPosition;
+        }
+        processSubspacePart(subspaceIndex, indexInSubspace, numValues, values);
+      }
+      chunkPosition += numValues;
+      indexInSubspace += numValues;
+      if (indexInSubspace == subspaceSizes[subspaceIndex]) {
+        ++subspaceIndex;
+        indexInSubspace = 0;
+      }
+    }
+  };
+  return mpiio::readValuesConsecutiveChunked<ElementType>(
+      len, fileNames, dsg.getCommunicator(), numElementsToBuffer, processChunk);
+}
+
+/**
+ * @brief the subspaces of dsg grouped by their level sum, coarse levels first, each group in
+ * subspace index order; these are the blocks of a progressive file, cf. writeProgressiveFile
+ */
+template <typename SparseGridType>
+std::map<LevelType, std::vector<typename SparseGridType::SubspaceIndexType>>
+getSubspacesByLevelSum(const SparseGridType& dsg) {
+  assert(dsg.getAllLevelVectors().size() > 0);
+  std::map<LevelType, std::vector<typename SparseGridType::SubspaceIndexType>> blocks;
+  for (typename SparseGridType::SubspaceIndexType i = 0;
+       i < static_cast<typename SparseGridType::SubspaceIndexType>(dsg.getNumSubspaces()); ++i) {
+    blocks[levelSum(dsg.getLevelVector(i))].push_back(i);
+  }
+  return blocks;
+}
+
+/**
+ * @brief the number of values of this process and its offset within the block in each block of a
+ * progressive file, and the blocks' global sizes
+ */
+template <typename SparseGridType>
+void getProgressiveBlockSizes(
+    const SparseGridType& dsg,
+    const std::map<LevelType, std::vector<typename SparseGridType::SubspaceIndexType>>& blocks,
+    std::vector<MPI_Offset>& myBlockSizes, std::vector<MPI_Offset>& myBlockOffsets,
+    std::vector<MPI_Offset>& globalBlockSizes) {
+  const auto numBlocks = static_cast<int>(blocks.size());
+  myBlockSizes.assign(numBlocks, 0);
+  myBlockOffsets.assign(numBlocks, 0);
+  globalBlockSizes.assign(numBlocks, 0);
+  size_t b = 0;
+  for (const auto& block : blocks) {
+    for (const auto& s : block.second) {
+      myBlockSizes[b] += dsg.getAllocatedDataSize(s);
+    }
+    ++b;
+  }
+  MPI_Exscan(myBlockSizes.data(), myBlockOffsets.data(), numBlocks, MPI_OFFSET, MPI_SUM,
+             dsg.getCommunicator());
+  if (dsg.getRank() == 0) {
+    // MPI_Exscan leaves the first rank's result undefined
+    std::fill(myBlockOffsets.begin(), myBlockOffsets.end(), 0);
+  }
+  MPI_Allreduce(myBlockSizes.data(), globalBlockSizes.data(), numBlocks, MPI_OFFSET, MPI_SUM,
+                dsg.getCommunicator());
+}
+
+/**
+ * @brief writes the sparse grid to a single file that is ordered by subspace level sum, coarse
+ * levels first, such that any prefix of the file holds a coarser, but consistent sparse grid
+ * function
+ *
+ * Within each level sum, the data is ordered by rank, like in writeOneFile. The file
+ * fileName.index lists the level sum, first value and number of values of each block that was
+ * written (cf. readProgressiveFile).
+ *
+ * @param maxBytesToWrite if > 0, only as many complete level sums are written as fit into this
+ * many bytes, e.g. to bound the time for output or for transfers over slow links
+ * @return the number of level sums written
+ */
+template <typename SparseGridType>
+int writeProgressiveFile(const SparseGridType& dsg, const std::string& fileName,
+                         MPI_Offset maxBytesToWrite = 0) {
+  using ElementType = typename SparseGridType::ElementType;
+  assert(dsg.isSubspaceDataCreated());
+  auto comm = dsg.getCommunicator();
+  const auto blocks = getSubspacesByLevelSum(dsg);
+  std::vector<MPI_Offset> myBlockSizes, myBlockOffsets, globalBlockSizes;
+  getProgressiveBlockSizes(dsg, blocks, myBlockSizes, myBlockOffsets, globalBlockSizes);
+
+  // only write complete level sums within the budget
+  std::vector<MPI_Offset> blockStarts;
+  MPI_Offset fileSize = 0;
+  for (const auto& blockSize : globalBlockSizes) {
+    if (maxBytesToWrite > 0 &&
+        (fileSize + blockSize) * static_cast<MPI_Offset>(sizeof(ElementType)) > maxBytesToWrite) {
+      break;
+    }
+    blockStarts.push_back(fileSize);
+    fileSize += blockSize;
+  }
+
+  MPI_Info info = mpiio::getNewConsecutiveMpiInfo(false);
+  MPI_Info_set(info, "access_style", "write_once,sequential");
+  MPI_File fh;
+  int err = MPI_File_open(comm, fileName.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
+  if (err != MPI_SUCCESS) {
+    throw std::runtime_error("write: could not open! " + fileName + ": " +
+                             getMpiErrorString(err));
+  }
+  // remove the rest of a previous, longer file
+  MPI_File_set_size(fh, fileSize * sizeof(ElementType));
+  MPI_Datatype dataType = getMPIDatatype(abstraction::getabstractionDataType<ElementType>());
+  std::vector<ElementType> buffer;
+  size_t b = 0;
+  for (const auto& block : blocks) {
+    if (b == blockStarts.size()) break;
+    // gather this process's data of the level sum, which is spread over the raw data
+    buffer.clear();
+    buffer.reserve(myBlockSizes[b]);
+    for (const auto& s : block.second) {
+      buffer.insert(buffer.end(), dsg.getData(s), dsg.getData(s) + dsg.getAllocatedDataSize(s));
+    }
+    err = MPI_File_write_at_all(fh, (blockStarts[b] + myBlockOffsets[b]) * sizeof(ElementType),
+                                buffer.data(), static_cast<int>(buffer.size()), dataType,
+                                MPI_STATUS_IGNORE);
+    if (err != MPI_SUCCESS) {
+      std::cerr << err << " in MPI_File_write_at_all" << std::endl;
+      std::cerr << getMpiErrorString(err) << std::endl;
+    }
+    ++b;
+  }
+  MPI_File_close(&fh);
+  MPI_Info_free(&info);
+
+  if (dsg.getRank() == 0) {
+    std::ofstream ofs(fileName + ".index");
+    ofs << "# level sum, first value, number of values" << std::endl;
+    b = 0;
+    for (const auto& block : blocks) {
+      if (b == blockStarts.size()) break;
+      ofs << block.first << " " << blockStarts[b] << " " << globalBlockSizes[b] << std::endl;
+      ++b;
+    }
+  }
+  return static_cast<int>(blockStarts.size());
+}
+
+/**
+ * @brief reads the coarsest level sums (up to maxLevelSum) from a file written by
+ * writeProgressiveFile for a sparse grid with the same subspace sizes; the finer subspaces are
+ * set to zero
+ *
+ * @return the number of level sums read
+ */
+template <typename SparseGridType>
+int readProgressiveFile(SparseGridType& dsg, const std::string& fileName,
+                        LevelType maxLevelSum = std::numeric_limits<LevelType>::max()) {
+  using ElementType = typename SparseGridType::ElementType;
+  assert(dsg.isSubspaceDataCreated());
+  auto comm = dsg.getCommunicator();
+  const auto blocks = getSubspacesByLevelSum(dsg);
+  std::vector<MPI_Offset> myBlockSizes, myBlockOffsets, globalBlockSizes;
+  getProgressiveBlockSizes(dsg, blocks, myBlockSizes, myBlockOffsets, globalBlockSizes);
+
+  // the first process reads the index: level sum, first value and number of values per block
+  std::vector<MPI_Offset> index;
+  bool indexFound = true;
+  if (dsg.getRank() == 0) {
+    std::ifstream ifs(fileName + ".index");
+    indexFound = ifs.good();
+    std::string line;
+    while (std::getline(ifs, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      std::stringstream lineStream(line);
+      MPI_Offset levelSumOfBlock, blockStart, blockSize;
+      lineStream >> levelSumOfBlock >> blockStart >> blockSize;
+      if (levelSumOfBlock > static_cast<MPI_Offset>(maxLevelSum)) break;
+      index.insert(index.end(), {levelSumOfBlock, blockStart, blockSize});
+    }
+  }
+  int indexSize = indexFound ? static_cast<int>(index.size()) : -1;
+  MPI_Bcast(&indexSize, 1, MPI_INT, 0, comm);
+  if (indexSize < 0) {
+    throw std::runtime_error("read: could not open index of " + fileName);
+  }
+  index.resize(indexSize);
+  MPI_Bcast(index.data(), indexSize, MPI_OFFSET, 0, comm);
+  const auto numBlocksToRead = index.size() / 3;
+
+  MPI_Info info = mpiio::getNewConsecutiveMpiInfo(false);
+  MPI_Info_set(info, "access_style", "read_once,sequential");
+  MPI_File fh;
+  int err = MPI_File_open(comm, fileName.c_str(), MPI_MODE_RDONLY, info, &fh);
+  if (err != MPI_SUCCESS) {
+    throw std::runtime_error("read: could not open! " + fileName + ": " + getMpiErrorString(err));
+  }
+  dsg.setZero();
+  MPI_Datatype dataType = getMPIDatatype(abstraction::getabstractionDataType<ElementType>());
+  std::vector<ElementType> buffer;
+  size_t b = 0;
+  for (const auto& block : blocks) {
+    if (b == numBlocksToRead) break;
+    if (index[3 * b] != block.first || index[3 * b + 2] != globalBlockSizes[b]) {
+      throw std::runtime_error("read: the progressive file " + fileName +
+                               " does not match the sparse grid");
+    }
+    buffer.resize(myBlockSizes[b]);
+    err = MPI_File_read_at_all(fh, (index[3 * b + 1] + myBlockOffsets[b]) * sizeof(ElementType),
+                               buffer.data(), static_cast<int>(buffer.size()), dataType,
+                               MPI_STATUS_IGNORE);
+    if (err != MPI_SUCCESS) {
+      std::cerr << err << " in MPI_File_read_at_all" << std::endl;
+    }
+    // distribute the data to the subspaces of the level sum
+    auto readPointer = buffer.cbegin();
+    for (const auto& s : block.second) {
+      std::copy_n(readPointer, dsg.getAllocatedDataSize(s), dsg.getData(s));
+      std::advance(readPointer, dsg.getAllocatedDataSize(s));
+    }
+    ++b;
+  }
+  MPI_File_close(&fh);
+  MPI_Info_free(&info);
+  return static_cast<int>(numBlocksToRead);
+}
+
 template <typename SparseGridType>
 int writeSomeFiles(const SparseGridType& dsg, const std::string& fileName,
                    bool deleteExistingFile = false) {
@@ -227,6 +227,10 @@ class DistributedSparseGridUniform : public AnyDistributedSparseGrid {
 
   inline const FG_ELEMENT* getRawData() const;
 
+  // returns a pointer to the Kahan terms of subspace i, or nullptr if the Kahan buffer has none
+  // for it (e.g. because the subspace was empty when the buffer was created)
+  inline FG_ELEMENT* getKahanData(SubspaceIndexType i);
+
   inline DimType getDim() const;
 
   // clear the levels_ vector, it is only necessary for registration of full grids
@@ -496,6 +500,23 @@ inline const FG_ELEMENT* DistributedSparseGridUniform<FG_ELEMENT>::getRawData()
   return this->subspacesDataContainer_.subspacesData_.data();
 }
 
+template <typename FG_ELEMENT>
+inline FG_ELEMENT* DistributedSparseGridUniform<FG_ELEMENT>::getKahanData(SubspaceIndexType i) {
+  auto& kahanData = this->subspacesDataContainer_.kahanData_;
+  const auto& kahanDataBegin = this->subspacesDataContainer_.kahanDataBegin_;
+  if (kahanData.empty() || static_cast<size_t>(i) >= kahanDataBegin.size() ||
+      kahanDataBegin[i] == nullptr) {
+    return nullptr;
+  }
+  const FG_ELEMENT* kahanDataEnd = static_cast<size_t>(i) + 1 < kahanDataBegin.size()
+                                       ? kahanDataBegin[i + 1]
+                                       : kahanData.data() + kahanData.size();
+  if (kahanDataEnd - kahanDataBegin[i] != static_cast<std::ptrdiff_t>(this->getDataSize(i))) {
+    return nullptr;
+  }
+  return kahanDataBegin[i];
+}
+
 template <typename FG_ELEMENT>
 void DistributedSparseGridUniform<FG_ELEMENT>::swapDataContainers(
     DistributedSparseGridDataContainer<FG_ELEMENT>& otherContainer) {
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sparsegrid/DistributedSparseGridEvaluator.hpp"
+#include "sparsegrid/DistributedSparseGridIO.hpp"
+#include "sparsegrid/DistributedSparseGridUniform.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief compares two sparse grid files (e.g. written by ProcessGroupWorker::writeDSGsToDisk)
+ * in hierarchical space, while streaming them in chunks -- the sparse grid's data is never
+ * allocated, so the memory needed is bounded by the chunk size
+ *
+ * Per subspace, the maximum and the basis-function-weighted L1 and L2 norms of the surplus
+ * differences are computed. Since the hat functions of a subspace sum up to at most one at every
+ * point, these bound the difference function's norms on the subspace, and their sums over all
+ * subspaces bound the norms of the whole difference function (cf. getErrorBounds).
+ * Additionally, both functions can be evaluated at (e.g. Monte-Carlo) points, which gives
+ * pointwise errors, also with respect to other representations of the solution.
+ */
+template <typename FG_ELEMENT>
+class SparseGridFileComparison {
+ public:
+  using SubspaceIndexType = typename AnyDistributedSparseGrid::SubspaceIndexType;
+
+  struct SubspaceDifference {
+    real maxAbs = 0.;     // the maximum surplus difference
+    real l1 = 0.;         // the sum of the surplus differences times the basis function integrals
+    real l2Squared = 0.;  // the sum of the squared surplus differences times the integrals
+  };
+
+  /**
+   * @param dsg the sparse grid that describes the files' layout; it only needs the subspace
+   * sizes (e.g. from registering the component grids, or from
+   * DistributedSparseGridIO::readSubspaceSizesFromFile) and no data
+   * @param referenceGrid cf. DistributedSparseGridEvaluator
+   * @param lmin cf. DistributedSparseGridEvaluator
+   */
+  SparseGridFileComparison(const DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                           const DistributedFullGrid<FG_ELEMENT>& referenceGrid,
+                           const LevelVector& lmin)
+      : dsg_(dsg), evaluator_(dsg, referenceGrid, lmin) {}
+
+  /**
+   * @brief streams both files and computes the subspace differences and, if coordinates are
+   * given, both files' function values at the coordinates
+   *
+   * collective on the sparse grid's communicator, all processes get all results
+   *
+   * @param numElementsToBuffer the number of values per file that are read at once, e.g. from
+   * CombiCom::getGlobalReduceChunkSize
+   * @param interpolationCoords coordinates on the unit square [0,1]^D
+   */
+  void compare(const std::string& fileName, const std::string& otherFileName,
+               int numElementsToBuffer,
+               const std::vector<std::vector<real>>& interpolationCoords = {}) {
+    const auto numSubspaces = dsg_.getNumSubspaces();
+    std::vector<real> maxAbs(numSubspaces, 0.);
+    std::vector<real> sums(2 * numSubspaces, 0.);
+    for (auto& values : values_) {
+      values.assign(interpolationCoords.size(), 0.);
+    }
+    std::vector<real> integrals;
+    DistributedSparseGridIO::readFilesChunked(
+        dsg_, {fileName, otherFileName}, numElementsToBuffer,
+        [&](SubspaceIndexType s, SubspaceSizeType first, SubspaceSizeType numValues,
+            const std::vector<const FG_ELEMENT*>& partValues) {
+          evaluator_.getBasisIntegrals(s, first, numValues, integrals);
+          for (SubspaceSizeType i = 0; i < numValues; ++i) {
+            const real difference = std::abs(partValues[0][i] - partValues[1][i]);
+            maxAbs[s] = std::max(maxAbs[s], difference);
+            sums[2 * s] += difference * integrals[i];
+            sums[2 * s + 1] += difference * difference * integrals[i];
+          }
+          if (!interpolationCoords.empty()) {
+            for (size_t f = 0; f < values_.size(); ++f) {
+              evaluator_.addSubspacePartValues(s, first, numValues, partValues[f],
+                                               interpolationCoords, values_[f]);
+            }
+          }
+        });
+
+    const auto comm = dsg_.getCommunicator();
+    const auto realType = abstraction::getMPIDatatype(abstraction::getabstractionDataType<real>());
+    MPI_Allreduce(MPI_IN_PLACE, maxAbs.data(), static_cast<int>(numSubspaces), realType, MPI_MAX,
+                  comm);
+    MPI_Allreduce(MPI_IN_PLACE, sums.data(), static_cast<int>(sums.size()), realType, MPI_SUM,
+                  comm);
+    subspaceDifferences_.resize(numSubspaces);
+    for (SubspaceIndexType s = 0; s < numSubspaces; ++s) {
+      subspaceDifferences_[s] = {maxAbs[s], sums[2 * s], sums[2 * s + 1]};
+    }
+    if (!interpolationCoords.empty()) {
+      const auto dataType =
+          abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
+      for (auto& values : values_) {
+        MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(values.size()), dataType,
+                      MPI_SUM, comm);
+      }
+    }
+  }
+
+  /** the differences per subspace, from the last call to compare */
+  const std::vector<SubspaceDifference>& getSubspaceDifferences() const {
+    return subspaceDifferences_;
+  }
+
+  /**
+   * @brief upper bounds for the maximum, L1 and L2 norm of the difference function, indexed by p
+   * as in DistributedFullGrid::getLpNorms
+   */
+  std::array<real, 3> getErrorBounds() const {
+    std::array<real, 3> bounds = {0., 0., 0.};
+    for (const auto& difference : subspaceDifferences_) {
+      bounds[0] += difference.maxAbs;
+      bounds[1] += difference.l1;
+      bounds[2] += std::sqrt(difference.l2Squared);
+    }
+    return bounds;
+  }
+
+  /**
+   * @brief the function values of the file with index fileIndex (0 or 1, in the order passed to
+   * compare) at the coordinates passed to compare
+   */
+  const std::vector<FG_ELEMENT>& getInterpolatedValues(size_t fileIndex) const {
+    return values_[fileIndex];
+  }
+
+  /**
+   * @brief the maximum, mean and root mean square of the absolute differences between values and
+   * otherValues, i.e. estimates of the maximum, L1 and L2 norm of the difference function if the
+   * values belong to uniformly distributed random points
+   */
+  static std::array<real, 3> getPointwiseErrors(const std::vector<FG_ELEMENT>& values,
+                                                const std::vector<FG_ELEMENT>& otherValues) {
+    assert(values.size() == otherValues.size());
+    std::array<real, 3> errors = {0., 0., 0.};
+    if (values.empty()) return errors;
+    for (size_t i = 0; i < values.size(); ++i) {
+      const real difference = std::abs(values[i] - otherValues[i]);
+      errors[0] = std::max(errors[0], difference);
+      errors[1] += difference;
+      errors[2] += difference * difference;
+    }
+    errors[1] /= static_cast<real>(values.size());
+    errors[2] = std::sqrt(errors[2] / static_cast<real>(values.size()));
+    return errors;
+  }
+
+  /**
+   * @brief writes the subspace differences to filename, one line per subspace, like
+   * DistributedSparseGridIO::writeMinMaxCoefficents; only needs to be called by one process
+   */
+  void writeSubspaceDifferences(const std::string& filename) const {
+    std::ofstream ofs(filename);
+    ofs << "# level : max, L1, L2 of the surplus differences" << std::endl;
+    for (SubspaceIndexType s = 0; s < static_cast<SubspaceIndexType>(subspaceDifferences_.size());
+         ++s) {
+      const auto& difference = subspaceDifferences_[s];
+      ofs << dsg_.getLevelVector(s) << " : " << difference.maxAbs << ", " << difference.l1 << ", "
+          << std::sqrt(difference.l2Squared) << std::endl;
+    }
+  }
+
+ private:
+  const DistributedSparseGridUniform<FG_ELEMENT>& dsg_;
+
+  DistributedSparseGridEvaluator<FG_ELEMENT> evaluator_;
+
+  std::vector<SubspaceDifference> subspaceDifferences_;
+
+  std::array<std::vector<FG_ELEMENT>, 2> values_;
+};
+
+}  // namespace combigrid
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/LevelVector.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief describes a lower-dimensional projection of a sparse grid function onto a uniform grid,
+ * cf. DistributedSparseGridEvaluator::getProjectedValues
+ *
+ * every dimension is either kept (as a dimension of the output grid), fixed to a slice
+ * coordinate, or integrated over (a marginal)
+ */
+struct SparseGridProjection {
+  /// the name of the projection, used as prefix for its output files
+  std::string name;
+  /// per dimension, the coordinate of the slice, or NaN if the dimension is not sliced
+  std::vector<real> sliceCoords;
+  /// per dimension, whether the function is integrated over it
+  std::vector<bool> integratedDims;
+  /// per dimension, the level of the output grid (2^l + 1 points), used for the kept dimensions
+  LevelVector outputLevel;
+
+  SparseGridProjection() = default;
+
+  SparseGridProjection(std::string name, std::vector<real> sliceCoords,
+                       std::vector<bool> integratedDims, LevelVector outputLevel)
+      : name(std::move(name)),
+        sliceCoords(std::move(sliceCoords)),
+        integratedDims(std::move(integratedDims)),
+        outputLevel(std::move(outputLevel)) {}
+
+  /** a projection that integrates over all dimensions except the kept ones */
+  static SparseGridProjection marginal(const std::string& name, DimType dim,
+                                       const std::vector<DimType>& keptDims,
+                                       const LevelVector& outputLevel) {
+    std::vector<bool> integratedDims(dim, true);
+    for (const auto& d : keptDims) integratedDims[d] = false;
+    return SparseGridProjection(
+        name, std::vector<real>(dim, std::numeric_limits<real>::quiet_NaN()), integratedDims,
+        outputLevel);
+  }
+
+  inline bool isKept(DimType d) const { return !integratedDims[d] && std::isnan(sliceCoords[d]); }
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    ar& name;
+    ar& sliceCoords;
+    ar& integratedDims;
+    ar& outputLevel;
+  }
+};
+
+}  // namespace combigrid
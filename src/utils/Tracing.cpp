@@ -0,0 +1,273 @@
+#include "utils/Tracing.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include "io/MPIInputOutput.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace combigrid {
+
+std::vector<std::unique_ptr<Tracing::ThreadBuffer>> Tracing::threadBuffers_;
+std::atomic<bool> Tracing::active_{false};
+std::atomic<size_t> Tracing::generation_{0};
+std::chrono::steady_clock::time_point Tracing::init_time_;
+
+namespace {
+struct EventRegistry {
+  std::mutex mutex;
+  std::vector<std::string> names;
+  std::unordered_map<std::string, Tracing::EventID> ids;
+};
+
+EventRegistry& getEventRegistry() {
+  static EventRegistry registry;
+  return registry;
+}
+
+struct ThreadBufferRegistry {
+  std::mutex mutex;
+  size_t capacity = Tracing::defaultRecordsPerThread;
+};
+
+ThreadBufferRegistry& getThreadBufferRegistry() {
+  static ThreadBufferRegistry registry;
+  return registry;
+}
+
+size_t nextPowerOfTwo(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+}  // namespace
+
+Tracing::EventID Tracing::registerEvent(const std::string& name) {
+  auto& registry = getEventRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto found = registry.ids.find(name);
+  if (found != registry.ids.end()) {
+    return found->second;
+  }
+  auto id = static_cast<EventID>(registry.names.size());
+  registry.names.push_back(name);
+  registry.ids[name] = id;
+  return id;
+}
+
+std::string Tracing::getEventName(EventID event) {
+  auto& registry = getEventRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  assert(event < registry.names.size());
+  return registry.names[event];
+}
+
+void Tracing::initialize(size_t recordsPerThread) {
+  assert(!isActive());
+  assert(recordsPerThread > 0);
+  auto& registry = getThreadBufferRegistry();
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    const auto capacity = nextPowerOfTwo(recordsPerThread);
+    if (capacity == registry.capacity) {
+      // reuse the buffers, as threads may still hold cached pointers to them
+      for (auto& buffer : threadBuffers_) {
+        buffer->head.store(0, std::memory_order_release);
+      }
+    } else {
+      // the buffers are freed, so no other thread may be recording at this point
+#ifdef _OPENMP
+      assert(!omp_in_parallel());
+#endif
+      registry.capacity = capacity;
+      threadBuffers_.clear();
+      // invalidate the threads' cached buffer pointers
+      generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+  }
+  init_time_ = std::chrono::steady_clock::now();
+  active_.store(true, std::memory_order_release);
+}
+
+void Tracing::finalize() { active_.store(false, std::memory_order_release); }
+
+Tracing::ThreadBuffer& Tracing::registerThread() {
+  auto& registry = getThreadBufferRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto buffer = std::make_unique<ThreadBuffer>();
+  buffer->records.resize(registry.capacity);
+  buffer->mask = registry.capacity - 1;
+  buffer->head.store(0, std::memory_order_relaxed);
+  buffer->thread = static_cast<uint16_t>(threadBuffers_.size());
+  threadBuffers_.push_back(std::move(buffer));
+  return *threadBuffers_.back();
+}
+
+size_t Tracing::getNumberOfRecords() {
+  std::lock_guard<std::mutex> lock(getThreadBufferRegistry().mutex);
+  size_t numRecords = 0;
+  for (const auto& buffer : threadBuffers_) {
+    numRecords += std::min(buffer->head.load(std::memory_order_acquire), buffer->records.size());
+  }
+  return numRecords;
+}
+
+size_t Tracing::getNumberOfDroppedRecords() {
+  std::lock_guard<std::mutex> lock(getThreadBufferRegistry().mutex);
+  size_t numDropped = 0;
+  for (const auto& buffer : threadBuffers_) {
+    auto head = buffer->head.load(std::memory_order_acquire);
+    if (head > buffer->records.size()) {
+      numDropped += head - buffer->records.size();
+    }
+  }
+  return numDropped;
+}
+
+#ifdef TIMING
+namespace {
+// escape the characters that would break a JSON string
+std::string escapeJSON(const std::string& s) {
+  std::string escaped;
+  escaped.reserve(s.size());
+  for (const auto& c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      escaped += ' ';
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+}  // namespace
+
+void Tracing::writeChromeTrace(const std::string& path, CommunicatorType comm) {
+  assert(!isActive());
+  const int rank = getCommRank(comm);
+  const int size = getCommSize(comm);
+
+  std::vector<std::string> escapedNames;
+  {
+    auto& registry = getEventRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& name : registry.names) {
+      escapedNames.push_back(escapeJSON(name));
+    }
+  }
+
+  std::stringstream buffer;
+  buffer << std::fixed << std::setprecision(3);
+  if (rank == 0) {
+    buffer << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+  }
+  // every rank has at least its process name, so the separators stay valid
+  buffer << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+         << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+  {
+    std::lock_guard<std::mutex> lock(getThreadBufferRegistry().mutex);
+    for (const auto& threadBuffer : threadBuffers_) {
+      buffer << "," << std::endl
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank
+             << ",\"tid\":" << threadBuffer->thread << ",\"args\":{\"name\":\"thread "
+             << threadBuffer->thread << "\"}}";
+      const auto head = threadBuffer->head.load(std::memory_order_acquire);
+      const auto capacity = threadBuffer->records.size();
+      const size_t first = head > capacity ? head - capacity : 0;
+      // if the ring buffer overflowed, skip the ends whose begins were overwritten
+      int depth = 0;
+      for (size_t i = first; i < head; ++i) {
+        const Record& r = threadBuffer->records[i & threadBuffer->mask];
+        if (r.type == RecordType::end) {
+          if (depth == 0) continue;
+          --depth;
+        } else {
+          ++depth;
+        }
+        buffer << "," << std::endl
+               << "{\"name\":\"" << escapedNames[r.event] << "\",\"ph\":\""
+               << (r.type == RecordType::begin ? "B" : "E") << "\",\"ts\":"
+               << static_cast<double>(r.timeInNanoseconds) / 1000. << ",\"pid\":" << rank
+               << ",\"tid\":" << r.thread;
+        if (r.bytes > 0) {
+          buffer << ",\"args\":{\"bytes\":" << r.bytes << "}";
+        }
+        buffer << "}";
+      }
+    }
+  }
+  if (rank != size - 1) {
+    buffer << "," << std::endl;
+  } else {
+    buffer << std::endl << "]}" << std::endl;
+  }
+
+  const std::string myJSONpart = buffer.str();
+  [[maybe_unused]] bool success = mpiio::writeValuesConsecutive<char>(
+      myJSONpart.data(), myJSONpart.size(), path, comm, true, false);
+  assert(success);
+}
+
+void Tracing::writeBinary(const std::string& path, CommunicatorType comm) {
+  assert(!isActive());
+  const int32_t rank = static_cast<int32_t>(getCommRank(comm));
+
+  std::vector<std::string> names;
+  {
+    auto& registry = getEventRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    names = registry.names;
+  }
+  std::vector<Record> records;
+  {
+    std::lock_guard<std::mutex> lock(getThreadBufferRegistry().mutex);
+    for (const auto& threadBuffer : threadBuffers_) {
+      const auto head = threadBuffer->head.load(std::memory_order_acquire);
+      const auto capacity = threadBuffer->records.size();
+      for (size_t i = head > capacity ? head - capacity : 0; i < head; ++i) {
+        records.push_back(threadBuffer->records[i & threadBuffer->mask]);
+      }
+    }
+  }
+
+  std::string myPart;
+  auto append = [&myPart](const void* data, size_t numBytes) {
+    myPart.append(reinterpret_cast<const char*>(data), numBytes);
+  };
+  const char magic[8] = {'D', 'C', 'T', 'T', 'R', 'A', 'C', 'E'};
+  append(magic, sizeof(magic));
+  append(&rank, sizeof(rank));
+  const auto numNames = static_cast<uint32_t>(names.size());
+  append(&numNames, sizeof(numNames));
+  const auto numRecords = static_cast<uint64_t>(records.size());
+  append(&numRecords, sizeof(numRecords));
+  for (const auto& name : names) {
+    const auto nameLength = static_cast<uint32_t>(name.size());
+    append(&nameLength, sizeof(nameLength));
+    append(name.data(), name.size());
+  }
+  append(records.data(), records.size() * sizeof(Record));
+
+  [[maybe_unused]] bool success =
+      mpiio::writeValuesConsecutive<char>(myPart.data(), myPart.size(), path, comm, true, false);
+  assert(success);
+}
+#else
+void Tracing::writeChromeTrace([[maybe_unused]] const std::string& path,
+                               [[maybe_unused]] CommunicatorType comm) {}
+void Tracing::writeBinary([[maybe_unused]] const std::string& path,
+                          [[maybe_unused]] CommunicatorType comm) {}
+#endif  // def TIMING
+
+}  // namespace combigrid
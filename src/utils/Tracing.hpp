@@ -0,0 +1,201 @@
+#ifndef TRACING_HPP_
+#define TRACING_HPP_
+
+// to resolve https://github.com/open-mpi/ompi/issues/5157
+#define OMPI_SKIP_MPICXX 1
+#include <mpi.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mpi/MPISystem.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief low-overhead tracing backend to complement Stats
+ *
+ * In contrast to Stats, events are identified by integer IDs that are registered once
+ * (typically through a function-local static, cf. TRACE_SCOPE), so that begin/end pairs can be
+ * recorded in inner loops without string hashing. Every thread records into its own ring buffer,
+ * which it exclusively writes to; so no locks are taken on the hot path. If a buffer overflows,
+ * the oldest records are overwritten.
+ *
+ * The traces can be written in Chrome Trace Event JSON (viewable with chrome://tracing or
+ * https://ui.perfetto.dev) or in a compact binary format; in both cases all ranks of the
+ * communicator write in parallel to a single file with MPI-IO.
+ *
+ * Like Stats, recording is only compiled in if TIMING is defined, and only active between
+ * initialize() and finalize().
+ */
+class Tracing {
+ public:
+  typedef uint32_t EventID;
+
+  enum class RecordType : uint8_t { begin = 0, end = 1 };
+
+  /** one begin or end record, fixed layout as it is also the binary output format */
+  struct Record {
+    int64_t timeInNanoseconds;  // since initialize()
+    uint64_t bytes;             // only set for end records of communication events
+    EventID event;
+    uint16_t thread;
+    RecordType type;
+    uint8_t padding;
+  };
+  static_assert(sizeof(Record) == 24, "Record layout must be fixed for binary output");
+
+  static constexpr size_t defaultRecordsPerThread = static_cast<size_t>(1) << 16;
+
+  /**
+   * register an event name and get the ID to use with begin / end; registering the same name
+   * twice returns the same ID. Thread-safe, but not meant for hot paths.
+   */
+  static EventID registerEvent(const std::string& name);
+
+  static std::string getEventName(EventID event);
+
+  /**
+   * start recording; the ring buffers of all threads get a capacity of recordsPerThread
+   * (rounded up to the next power of two). If the capacity is the same as before, the existing
+   * buffers are cleared and reused; otherwise they are re-created, which is only allowed while
+   * no other thread is recording (i.e., outside of parallel regions).
+   */
+  static void initialize(size_t recordsPerThread = defaultRecordsPerThread);
+
+  /** stop recording, call before writing */
+  static void finalize();
+
+  /** whether records are taken; always false if TIMING is not defined */
+  static bool isActive() {
+#ifdef TIMING
+    return active_.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif  // def TIMING
+  }
+
+  /** record the beginning of an event in the calling thread */
+  static void begin(EventID event);
+
+  /** record the end of an event in the calling thread, optionally with a communicated volume */
+  static void end(EventID event, uint64_t bytes = 0);
+
+  /** number of records that are currently held in the buffers of all threads */
+  static size_t getNumberOfRecords();
+
+  /** number of records that were overwritten because a ring buffer was full */
+  static size_t getNumberOfDroppedRecords();
+
+  /**
+   * write the records in Chrome Trace Event JSON format (one process per rank,
+   * one track per thread), only call this after finalize
+   */
+  static void writeChromeTrace(const std::string& path,
+                               CommunicatorType comm = theMPISystem()->getWorldComm());
+
+  /**
+   * write the records in a compact binary format: for each rank in order, a header
+   * (magic "DCTTRACE", int32 rank, uint32 number of event names, uint64 number of records),
+   * the event names (each as uint32 length followed by the characters), and then the records
+   * as in struct Record; only call this after finalize
+   */
+  static void writeBinary(const std::string& path,
+                          CommunicatorType comm = theMPISystem()->getWorldComm());
+
+  /**
+   * RAII helper that records begin on construction and end on destruction
+   */
+  class Scope {
+   public:
+    explicit Scope(EventID event) : event_(event) { Tracing::begin(event_); }
+    ~Scope() { Tracing::end(event_, bytes_); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    /** attribute communicated bytes to this event */
+    void addBytes(uint64_t bytes) { bytes_ += bytes; }
+
+   private:
+    EventID event_;
+    uint64_t bytes_ = 0;
+  };
+
+ private:
+  struct ThreadBuffer {
+    std::vector<Record> records;
+    size_t mask;
+    std::atomic<size_t> head;
+    uint16_t thread;
+  };
+
+  static ThreadBuffer& getThreadBuffer();
+
+  static ThreadBuffer& registerThread();
+
+  static void record(EventID event, RecordType type, uint64_t bytes);
+
+  // the buffers are owned here, so they outlive the threads that write to them
+  static std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers_;
+  static std::atomic<bool> active_;
+  static std::atomic<size_t> generation_;
+  static std::chrono::steady_clock::time_point init_time_;
+};
+
+inline Tracing::ThreadBuffer& Tracing::getThreadBuffer() {
+  static thread_local ThreadBuffer* buffer = nullptr;
+  static thread_local size_t bufferGeneration = 0;
+  const auto currentGeneration = generation_.load(std::memory_order_acquire);
+  if (buffer == nullptr || bufferGeneration != currentGeneration) {
+    buffer = &registerThread();
+    bufferGeneration = currentGeneration;
+  }
+  return *buffer;
+}
+
+inline void Tracing::record(EventID event, RecordType type, uint64_t bytes) {
+  if (!isActive()) return;
+  ThreadBuffer& buffer = getThreadBuffer();
+  const auto head = buffer.head.load(std::memory_order_relaxed);
+  Record& r = buffer.records[head & buffer.mask];
+  r.timeInNanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                           init_time_)
+          .count();
+  r.bytes = bytes;
+  r.event = event;
+  r.thread = buffer.thread;
+  r.type = type;
+  r.padding = 0;
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+#ifdef TIMING
+inline void Tracing::begin(EventID event) { record(event, RecordType::begin, 0); }
+
+inline void Tracing::end(EventID event, uint64_t bytes) { record(event, RecordType::end, bytes); }
+#else
+inline void Tracing::begin([[maybe_unused]] EventID event) {}
+
+inline void Tracing::end([[maybe_unused]] EventID event, [[maybe_unused]] uint64_t bytes) {}
+#endif  // def TIMING
+
+}  // namespace combigrid
+
+#define DISCOTEC_TRACE_CONCAT_IMPL(a, b) a##b
+#define DISCOTEC_TRACE_CONCAT(a, b) DISCOTEC_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * declares a Tracing::Scope named scopeName for the event with the given name; the name is
+ * only registered on the first pass through this line
+ */
+#define TRACE_SCOPE(scopeName, eventName)                                            \
+  static const ::combigrid::Tracing::EventID DISCOTEC_TRACE_CONCAT(                 \
+      traceEventID_, __LINE__) = ::combigrid::Tracing::registerEvent(eventName);    \
+  ::combigrid::Tracing::Scope scopeName(DISCOTEC_TRACE_CONCAT(traceEventID_, __LINE__))
+
+#endif /* TRACING_HPP_ */
@@ -225,6 +225,11 @@ void checkDistributedFullgrid(LevelVector& levels, std::vector<int>& procs,
   auto maxnorm = dfg.getLpNorm(0);
   auto onenorm = dfg.getLpNorm(1);
   auto twonorm = dfg.getLpNorm(2);
+  // the fused norms need to agree with the separate ones
+  auto norms = dfg.getLpNorms();
+  BOOST_CHECK_EQUAL(norms[0], maxnorm);
+  BOOST_CHECK_CLOSE(norms[1], onenorm, TestHelper::tolerance);
+  BOOST_CHECK_CLOSE(norms[2], twonorm, TestHelper::tolerance);
   if (std::all_of(boundary.begin(), boundary.end(), [](BoundaryType i) { return i == 2; })) {
     // check that InnerNodalBasisFunctionIntegral is correct
     double numFullInnerBasisFcns = 1.;
@@ -667,6 +672,41 @@ BOOST_AUTO_TEST_CASE(interpolation_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(interpolation_batch_test) {
+  std::vector<int> procs = {2, 2, 2};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm != MPI_COMM_NULL) {
+    LevelVector fullGridLevel = {3, 2, 4};
+    DimType dim = static_cast<DimType>(procs.size());
+    for (BoundaryType b : {0, 1, 2}) {
+      std::vector<BoundaryType> boundary(dim, b);
+      OwningDistributedFullGrid<real> dfg(dim, fullGridLevel, comm, boundary, procs, false);
+      ParaboloidFn<CombiDataType> f;
+      std::vector<double> coords(dim);
+      for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+        dfg.getCoordsLocal(li, coords);
+        dfg.getData()[li] = f(coords);
+      }
+      // more than one batch, and the last one incomplete
+      auto interpolationCoords = montecarlo::getRandomCoordinates(
+          2 * DistributedFullGrid<real>::evalBatchSize + 17, static_cast<size_t>(dim));
+      interpolationCoords.push_back(std::vector<real>(dim, 0.));
+      interpolationCoords.push_back(std::vector<real>(dim, 1.));
+
+      auto interpolatedValues = dfg.getInterpolatedValues(interpolationCoords);
+      std::vector<real> expectedValues(interpolationCoords.size());
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        expectedValues[i] = dfg.evalLocal(interpolationCoords[i]);
+      }
+      MPI_Allreduce(MPI_IN_PLACE, expectedValues.data(),
+                    static_cast<int>(expectedValues.size()), MPI_DOUBLE, MPI_SUM, comm);
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        BOOST_TEST(interpolatedValues[i] == expectedValues[i], boost::test_tools::tolerance(1e-12));
+      }
+    }
+  }
+}
+
 #ifdef NDEBUG  // speed test -> run only in release mode
 BOOST_AUTO_TEST_CASE(interpolation_speed_test) {
   std::vector<int> procs = {2, 2, 2, 1, 1, 1};
@@ -1235,6 +1275,54 @@ BOOST_AUTO_TEST_CASE(test_evalDFG) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(test_interpolationPlan) {
+  std::vector<int> procs = {2, 2, 2};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm != MPI_COMM_NULL) {
+    DimType dim = static_cast<DimType>(procs.size());
+    size_t numCoordinates = 1000;
+    auto interpolationCoords = montecarlo::getRandomCoordinates(numCoordinates, dim);
+    interpolationCoords.push_back(std::vector<double>(dim, 0.));
+    interpolationCoords.push_back(std::vector<double>(dim, 1. - 1e-10));
+    interpolationCoords.push_back(std::vector<double>(dim, 1.));
+    numCoordinates = interpolationCoords.size();
+
+    LevelVector fullGridLevel = {4, 3, 5};
+    for (auto b : std::vector<BoundaryType>({0, 1, 2})) {
+      BOOST_TEST_CHECKPOINT("Testing boundary type " + std::to_string(b));
+      std::vector<BoundaryType> boundary(dim, b);
+      OwningDistributedFullGrid<real> dfg(dim, fullGridLevel, comm, boundary, procs, false);
+      std::vector<double> coords(dim);
+      for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+        dfg.getCoordsLocal(li, coords);
+        dfg.getData()[li] = 1. + coords[0] * coords[1] - coords[2];
+      }
+      const auto plan = dfg.getInterpolationPlan(interpolationCoords);
+      BOOST_CHECK_EQUAL(plan.getNumCoordinates(), numCoordinates);
+      // only the owners of a point's neighbors contribute
+      BOOST_CHECK_LT(plan.getPoints().size(), numCoordinates);
+      BOOST_CHECK_LE(plan.getNumNonzeros(), plan.getPoints().size() * 8);
+      auto numContributions = plan.getPoints().size();
+      MPI_Allreduce(MPI_IN_PLACE, &numContributions, 1, MPI_UNSIGNED_LONG, MPI_SUM, comm);
+      BOOST_CHECK_GE(numContributions, numCoordinates);
+
+      // the plan is reusable when the values change
+      for (int step = 0; step < 2; ++step) {
+        const auto planValues = dfg.getInterpolatedValues(plan);
+        const auto values = dfg.getInterpolatedValues(interpolationCoords);
+        BOOST_REQUIRE_EQUAL(planValues.size(), numCoordinates);
+        for (size_t i = 0; i < numCoordinates; ++i) {
+          BOOST_CHECK_SMALL(std::abs(planValues[i] - values[i]), TestHelper::tolerance);
+        }
+        for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+          dfg.getData()[li] *= -2.;
+        }
+      }
+      MPI_Barrier(comm);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_massLoss2D) {
   std::vector<int> procs = {1, 1};
   CommunicatorType comm = TestHelper::getComm(procs);
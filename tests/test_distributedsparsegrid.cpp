@@ -5,8 +5,11 @@
 
 #include <boost/math/special_functions/binomial.hpp>
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 #include <complex>
 #include <cstdarg>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <random>
 #include <vector>
@@ -15,10 +18,13 @@
 #include "combicom/CombiCom.hpp"
 #include "combischeme/CombiMinMaxScheme.hpp"
 #include "fullgrid/FullGrid.hpp"
+#include "hierarchization/DistributedHierarchization.hpp"
 #include "manager/CombiParameters.hpp"
+#include "sparsegrid/DistributedSparseGridEvaluator.hpp"
 #include "sparsegrid/DistributedSparseGridIO.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
 #include "sparsegrid/SGrid.hpp"
+#include "sparsegrid/SparseGridFileComparison.hpp"
 #include "utils/IndexVector.hpp"
 #include "utils/LevelSetUtils.hpp"
 #include "utils/MonteCarlo.hpp"
@@ -61,7 +67,7 @@ void checkDistributedSparsegrid(LevelVector& lmin, LevelVector& lmax, std::vecto
         neighbor[d] += 1;
         std::stringstream stringStream;
         stringStream << "corner: " << corner << " neighbor: " << neighbor;
-        BOOST_TEST_CONTEXT(stringStream.str());
+        BOOST_TEST_INFO_SCOPE(stringStream.str());
         if (schemeIsRegular) {
           BOOST_CHECK(std::find(uniDSG->getAllLevelVectors().begin(),
                                 uniDSG->getAllLevelVectors().end(),
@@ -298,6 +304,277 @@ void checkDistributedSparsegrid(LevelVector& lmin, LevelVector& lmax, std::vecto
   }
 }
 
+/**
+ * @brief hierarchizes a full grid into a sparse grid containing all of its subspaces and checks
+ * that evaluating the sparse grid directly gives the full grid's interpolated values
+ */
+void checkSparseGridEvaluation(const LevelVector& level, std::vector<int> procs,
+                               const std::vector<BoundaryType>& boundary, const LevelVector& lmin) {
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  std::stringstream stringStream;
+  stringStream << "boundary " << static_cast<int>(boundary[0]) << " lmin " << lmin << " procs "
+               << procs;
+  BOOST_TEST_INFO_SCOPE(stringStream.str());
+  const auto dim = static_cast<DimType>(level.size());
+  auto decomposition = combigrid::getStandardDecomposition(level, procs);
+  OwningDistributedFullGrid<CombiDataType> dfg(dim, level, comm, boundary, procs, true,
+                                               decomposition);
+  ParaboloidFn<CombiDataType> f;
+  std::vector<double> coords(dim);
+  for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+    dfg.getCoordsLocal(li, coords);
+    dfg.getData()[li] = f(coords);
+  }
+  // the random coordinates need to be the same on all ranks
+  auto interpolationCoords = montecarlo::getRandomCoordinates(500, dim);
+  for (auto& coord : interpolationCoords) {
+    MPI_Bcast(coord.data(), dim, MPI_DOUBLE, 0, comm);
+  }
+  interpolationCoords.push_back(std::vector<real>(dim, 0.));
+  interpolationCoords.push_back(std::vector<real>(dim, 1.));
+  interpolationCoords.push_back(std::vector<real>(dim, 0.5));
+  const auto nodalValues = dfg.getInterpolatedValues(interpolationCoords);
+
+  // the full grid's xdmf output needs to hold the grid points' values
+  dfg.writeXdmfPlotFile("test_dfg_xdmf");
+  MPI_Barrier(comm);
+  if (dfg.getRank() == 0) {
+    std::ifstream binaryFile("test_dfg_xdmf.bin", std::ios::binary);
+    std::vector<CombiDataType> writtenValues(dfg.getNrElements());
+    binaryFile.read(reinterpret_cast<char*>(writtenValues.data()),
+                    writtenValues.size() * sizeof(CombiDataType));
+    BOOST_CHECK(binaryFile.good());
+    for (IndexType i = 0; i < dfg.getNrElements(); ++i) {
+      dfg.getCoordsGlobal(i, coords);
+      BOOST_CHECK_SMALL(std::abs(writtenValues[i] - f(coords)), TestHelper::tolerance);
+    }
+    BOOST_CHECK(std::ifstream("test_dfg_xdmf.xdmf").good());
+  }
+
+  HierarchicalHatBasisFunction hatBasis;
+  HierarchicalHatPeriodicBasisFunction periodicHatBasis;
+  std::vector<BasisFunctionBasis*> bases(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    bases[d] = boundary[d] == 1 ? static_cast<BasisFunctionBasis*>(&periodicHatBasis)
+                                : static_cast<BasisFunctionBasis*>(&hatBasis);
+  }
+  DistributedHierarchization::hierarchize<CombiDataType>(dfg, std::vector<bool>(dim, true), bases,
+                                                         lmin);
+
+  DistributedSparseGridUniform<CombiDataType> dsg(dim, getDownSet(level), comm);
+  dsg.registerDistributedFullGrid(dfg);
+  dsg.createSubspaceData();
+  dsg.addDistributedFullGrid(dfg, 1.);
+
+  DistributedFullGrid<CombiDataType> referenceGrid(dim, level, comm, boundary, nullptr, procs,
+                                                   true, decomposition);
+  DistributedSparseGridEvaluator<CombiDataType> evaluator(dsg, referenceGrid, lmin);
+  const auto sparseGridValues = evaluator.getInterpolatedValues(interpolationCoords);
+  for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+    BOOST_TEST_CONTEXT("point " << i);
+    BOOST_CHECK_SMALL(std::abs(sparseGridValues[i] - nodalValues[i]), TestHelper::tolerance);
+  }
+
+  // a downsampled slice, written in parallel, needs to match the evaluation at its points
+  std::vector<real> sliceCoords(dim, std::numeric_limits<real>::quiet_NaN());
+  sliceCoords[1] = 0.3;
+  LevelVector sliceLevel(dim, 2);
+  sliceLevel[0] = 3;
+  evaluator.writeSliceXdmf("test_slice_xdmf", sliceCoords, sliceLevel, 7);
+  std::vector<std::vector<real>> sliceInterpolationCoords;
+  for (IndexType j = 0; j <= powerOfTwoByBitshift(sliceLevel[2]); ++j) {
+    for (IndexType i = 0; i <= powerOfTwoByBitshift(sliceLevel[0]); ++i) {
+      sliceInterpolationCoords.push_back(
+          {static_cast<real>(i) * oneOverPowOfTwo[sliceLevel[0]], sliceCoords[1],
+           static_cast<real>(j) * oneOverPowOfTwo[sliceLevel[2]]});
+    }
+  }
+  const auto sliceValues = evaluator.getInterpolatedValues(sliceInterpolationCoords);
+  MPI_Barrier(comm);
+  if (TestHelper::getRank(comm) == 0) {
+    std::ifstream binaryFile("test_slice_xdmf.bin", std::ios::binary | std::ios::ate);
+    BOOST_CHECK_EQUAL(static_cast<size_t>(binaryFile.tellg()),
+                      sliceValues.size() * sizeof(CombiDataType));
+    binaryFile.seekg(0);
+    std::vector<CombiDataType> writtenValues(sliceValues.size());
+    binaryFile.read(reinterpret_cast<char*>(writtenValues.data()),
+                    writtenValues.size() * sizeof(CombiDataType));
+    for (size_t i = 0; i < sliceValues.size(); ++i) {
+      BOOST_CHECK_SMALL(std::abs(writtenValues[i] - sliceValues[i]), TestHelper::tolerance);
+    }
+    BOOST_CHECK(std::ifstream("test_slice_xdmf.xdmf").good());
+  }
+
+  // the same slice as projection
+  auto projectedSlice = evaluator.getProjectedValues(
+      SparseGridProjection("slice", sliceCoords, std::vector<bool>(dim, false), sliceLevel));
+  if (TestHelper::getRank(comm) == 0) {
+    BOOST_REQUIRE_EQUAL(projectedSlice.size(), sliceValues.size());
+    for (size_t i = 0; i < sliceValues.size(); ++i) {
+      BOOST_CHECK_SMALL(std::abs(projectedSlice[i] - sliceValues[i]), TestHelper::tolerance);
+    }
+  }
+
+  // marginal over the second dimension: the interpolant is linear between the grid points, so
+  // the trapezoidal rule on them is exact
+  auto marginal = evaluator.getProjectedValues(
+      SparseGridProjection::marginal("marginal", dim, {0, 2}, sliceLevel));
+  const auto numPoints1 = powerOfTwoByBitshift(level[1]);
+  std::vector<std::vector<real>> marginalInterpolationCoords;
+  for (const auto& sliceCoord : sliceInterpolationCoords) {
+    for (IndexType j = 0; j <= numPoints1; ++j) {
+      marginalInterpolationCoords.push_back(
+          {sliceCoord[0], static_cast<real>(j) * oneOverPowOfTwo[level[1]], sliceCoord[2]});
+    }
+  }
+  const auto marginalPointValues = evaluator.getInterpolatedValues(marginalInterpolationCoords);
+  if (TestHelper::getRank(comm) == 0) {
+    BOOST_REQUIRE_EQUAL(marginal.size(), sliceInterpolationCoords.size());
+    for (size_t i = 0; i < marginal.size(); ++i) {
+      CombiDataType integral = 0.;
+      for (IndexType j = 0; j <= numPoints1; ++j) {
+        const real weight = (j == 0 || j == numPoints1) ? 0.5 : 1.;
+        integral +=
+            weight * oneOverPowOfTwo[level[1]] * marginalPointValues[i * (numPoints1 + 1) + j];
+      }
+      BOOST_CHECK_SMALL(std::abs(marginal[i] - integral), TestHelper::tolerance);
+    }
+  }
+
+  // integrating over all dimensions gives the same as integrating a marginal on the grid's level
+  auto totalIntegral = evaluator.getProjectedValues(SparseGridProjection(
+      "integral", std::vector<real>(dim, std::numeric_limits<real>::quiet_NaN()),
+      std::vector<bool>(dim, true), LevelVector(dim, 0)));
+  auto marginal2 =
+      evaluator.getProjectedValues(SparseGridProjection::marginal("marginal2", dim, {2}, level));
+  if (TestHelper::getRank(comm) == 0) {
+    BOOST_REQUIRE_EQUAL(totalIntegral.size(), 1);
+    CombiDataType integral = 0.;
+    const auto numPoints2 = powerOfTwoByBitshift(level[2]);
+    for (IndexType j = 0; j <= numPoints2; ++j) {
+      const real weight = (j == 0 || j == numPoints2) ? 0.5 : 1.;
+      integral += weight * oneOverPowOfTwo[level[2]] * marginal2[j];
+    }
+    BOOST_CHECK_SMALL(std::abs(totalIntegral[0] - integral), TestHelper::tolerance);
+  }
+}
+
+/**
+ * @brief writes the hierarchical surpluses of two full grids to sparse grid files and checks that
+ * comparing the files in small chunks gives the same results as the sparse grids in memory
+ */
+void checkSparseGridFileComparison(const LevelVector& level, std::vector<int> procs,
+                                   const std::vector<BoundaryType>& boundary,
+                                   const LevelVector& lmin) {
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  std::stringstream stringStream;
+  stringStream << "boundary " << static_cast<int>(boundary[0]) << " lmin " << lmin << " procs "
+               << procs;
+  BOOST_TEST_INFO_SCOPE(stringStream.str());
+  const auto dim = static_cast<DimType>(level.size());
+  auto decomposition = combigrid::getStandardDecomposition(level, procs);
+  HierarchicalHatBasisFunction hatBasis;
+  HierarchicalHatPeriodicBasisFunction periodicHatBasis;
+  std::vector<BasisFunctionBasis*> bases(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    bases[d] = boundary[d] == 1 ? static_cast<BasisFunctionBasis*>(&periodicHatBasis)
+                                : static_cast<BasisFunctionBasis*>(&hatBasis);
+  }
+  ParaboloidFn<CombiDataType> f;
+  std::vector<std::unique_ptr<OwningDistributedFullGrid<CombiDataType>>> dfgs;
+  std::vector<std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>> dsgs;
+  const std::vector<std::string> fileNames = {"test_sg_compare_0", "test_sg_compare_1"};
+  for (size_t k = 0; k < 2; ++k) {
+    dfgs.emplace_back(new OwningDistributedFullGrid<CombiDataType>(dim, level, comm, boundary,
+                                                                   procs, true, decomposition));
+    auto& dfg = *dfgs.back();
+    std::vector<double> coords(dim);
+    for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+      dfg.getCoordsLocal(li, coords);
+      dfg.getData()[li] = f(coords) * (1. + 0.1 * static_cast<real>(k) * coords[0]);
+    }
+    DistributedHierarchization::hierarchize<CombiDataType>(dfg, std::vector<bool>(dim, true),
+                                                           bases, lmin);
+    dsgs.emplace_back(new DistributedSparseGridUniform<CombiDataType>(dim, getDownSet(level), comm));
+    dsgs.back()->registerDistributedFullGrid(dfg);
+    dsgs.back()->createSubspaceData();
+    dsgs.back()->addDistributedFullGrid(dfg, 1.);
+    DistributedSparseGridIO::writeOneFile(*dsgs.back(), fileNames[k], true);
+  }
+
+  // the sparse grid that describes the files' layout does not need any data
+  DistributedSparseGridUniform<CombiDataType> layoutDSG(dim, getDownSet(level), comm);
+  layoutDSG.registerDistributedFullGrid(*dfgs[0]);
+  DistributedFullGrid<CombiDataType> referenceGrid(dim, level, comm, boundary, nullptr, procs,
+                                                   true, decomposition);
+  auto interpolationCoords = montecarlo::getRandomCoordinates(100, dim);
+  for (auto& coord : interpolationCoords) {
+    MPI_Bcast(coord.data(), dim, MPI_DOUBLE, 0, comm);
+  }
+  SparseGridFileComparison<CombiDataType> comparison(layoutDSG, referenceGrid, lmin);
+  // a chunk size that splits the subspaces at odd positions
+  comparison.compare(fileNames[0], fileNames[1], 37, interpolationCoords);
+  BOOST_CHECK(!layoutDSG.isSubspaceDataCreated());
+
+  // the streamed function values match the evaluation in memory
+  for (size_t k = 0; k < 2; ++k) {
+    DistributedSparseGridEvaluator<CombiDataType> evaluator(*dsgs[k], referenceGrid, lmin);
+    const auto values = evaluator.getInterpolatedValues(interpolationCoords);
+    const auto& streamedValues = comparison.getInterpolatedValues(k);
+    BOOST_REQUIRE_EQUAL(streamedValues.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      BOOST_CHECK_SMALL(std::abs(streamedValues[i] - values[i]), TestHelper::tolerance);
+    }
+  }
+
+  // the streamed subspace differences match the ones in memory
+  DistributedSparseGridEvaluator<CombiDataType> evaluator(*dsgs[0], referenceGrid, lmin);
+  const auto& subspaceDifferences = comparison.getSubspaceDifferences();
+  BOOST_REQUIRE_EQUAL(subspaceDifferences.size(), layoutDSG.getNumSubspaces());
+  std::vector<real> integrals;
+  for (typename AnyDistributedSparseGrid::SubspaceIndexType s = 0;
+       s < layoutDSG.getNumSubspaces(); ++s) {
+    const auto numValues = layoutDSG.getDataSize(s);
+    evaluator.getBasisIntegrals(s, 0, numValues, integrals);
+    std::array<real, 3> difference = {0., 0., 0.};
+    for (size_t i = 0; i < numValues; ++i) {
+      const real absDifference = std::abs(dsgs[0]->getData(s)[i] - dsgs[1]->getData(s)[i]);
+      difference[0] = std::max(difference[0], absDifference);
+      difference[1] += absDifference * integrals[i];
+      difference[2] += absDifference * absDifference * integrals[i];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &difference[0], 1, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &difference[1], 2, MPI_DOUBLE, MPI_SUM, comm);
+    BOOST_CHECK_SMALL(subspaceDifferences[s].maxAbs - difference[0], TestHelper::tolerance);
+    BOOST_CHECK_SMALL(subspaceDifferences[s].l1 - difference[1], TestHelper::tolerance);
+    BOOST_CHECK_SMALL(subspaceDifferences[s].l2Squared - difference[2], TestHelper::tolerance);
+  }
+
+  // the bounds hold for the errors at the points, and for the integral of the difference
+  const auto bounds = comparison.getErrorBounds();
+  const auto pointwiseErrors = SparseGridFileComparison<CombiDataType>::getPointwiseErrors(
+      comparison.getInterpolatedValues(0), comparison.getInterpolatedValues(1));
+  BOOST_CHECK_GT(pointwiseErrors[0], 0.);
+  BOOST_CHECK_LE(pointwiseErrors[0], bounds[0]);
+  const SparseGridProjection integration(
+      "integral", std::vector<real>(dim, std::numeric_limits<real>::quiet_NaN()),
+      std::vector<bool>(dim, true), LevelVector(dim, 0));
+  const auto integral0 = evaluator.getProjectedValues(integration);
+  const auto integral1 = DistributedSparseGridEvaluator<CombiDataType>(*dsgs[1], referenceGrid, lmin)
+                             .getProjectedValues(integration);
+  if (TestHelper::getRank(comm) == 0) {
+    BOOST_CHECK_LE(std::abs(integral0[0] - integral1[0]), bounds[1] + TestHelper::tolerance);
+  }
+  BOOST_CHECK_LE(bounds[1], bounds[2] + TestHelper::tolerance);
+  BOOST_CHECK_LE(bounds[2], bounds[0] + TestHelper::tolerance);
+}
+
 BOOST_AUTO_TEST_SUITE(distributedsparsegrid, *boost::unit_test::timeout(1800))
 // very cheap
 BOOST_AUTO_TEST_CASE(test_0) {
@@ -640,7 +917,7 @@ BOOST_AUTO_TEST_CASE(test_createSubspacesSingleLevel_large) {
   for (const auto& level : created) {
     std::stringstream stringStream;
     stringStream << "level: " << level;
-    BOOST_TEST_CONTEXT(stringStream.str());
+    BOOST_TEST_INFO_SCOPE(stringStream.str());
     BOOST_REQUIRE(std::find(downSet.begin(), downSet.end(), level) != downSet.end());
   }
   BOOST_CHECK(std::is_sorted(downSet.begin(), downSet.end()));
@@ -782,6 +1059,81 @@ BOOST_AUTO_TEST_CASE(test_writeOneFile) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(test_writeProgressiveFile) {
+  std::vector<int> procs = {2, 2, 2};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm != MPI_COMM_NULL) {
+    DimType dim = static_cast<DimType>(procs.size());
+    LevelVector lmin = {1, 1, 1};
+    LevelVector lmax = {5, 4, 5};
+    std::vector<BoundaryType> boundary(dim, 2);
+    auto decomposition = combigrid::getStandardDecomposition(lmax, procs);
+    std::vector<std::unique_ptr<DistributedSparseGridUniform<combigrid::real>>> dsgs;
+    for (size_t k = 0; k < 2; ++k) {
+      dsgs.emplace_back(new DistributedSparseGridUniform<combigrid::real>(dim, lmax, lmin, comm));
+      for (const auto& level : dsgs.back()->getAllLevelVectors()) {
+        if (levelSum(level) == levelSum(lmin) + 4) {
+          auto dfgDecomposition =
+              combigrid::downsampleDecomposition(decomposition, lmax, level, boundary);
+          OwningDistributedFullGrid<combigrid::real> dfg(dim, level, comm, boundary, procs, true,
+                                                         dfgDecomposition);
+          dsgs.back()->registerDistributedFullGrid(dfg);
+        }
+      }
+      dsgs.back()->createSubspaceData();
+    }
+    auto& dsg = *dsgs[0];
+    auto& readDSG = *dsgs[1];
+    const auto rank = TestHelper::getRank(comm);
+    for (size_t i = 0; i < dsg.getRawDataSize(); ++i) {
+      dsg.getRawData()[i] = static_cast<real>(rank) + 1e-6 * static_cast<real>(i);
+    }
+    const auto blocks = DistributedSparseGridIO::getSubspacesByLevelSum(dsg);
+
+    // without a budget, all level sums are written and read back
+    auto numWritten = DistributedSparseGridIO::writeProgressiveFile(dsg, "test_sg_progressive");
+    BOOST_CHECK_EQUAL(numWritten, blocks.size());
+    auto numRead = DistributedSparseGridIO::readProgressiveFile(readDSG, "test_sg_progressive");
+    BOOST_CHECK_EQUAL(numRead, blocks.size());
+    for (size_t i = 0; i < dsg.getRawDataSize(); ++i) {
+      BOOST_CHECK_EQUAL(readDSG.getRawData()[i], dsg.getRawData()[i]);
+    }
+
+    // reading a prefix gives the coarse subspaces, the finer ones are zero
+    auto checkPrefix = [&](LevelType maxLevelSum) {
+      for (typename AnyDistributedSparseGrid::SubspaceIndexType s = 0; s < dsg.getNumSubspaces();
+           ++s) {
+        const bool isRead = levelSum(dsg.getLevelVector(s)) <= maxLevelSum;
+        for (size_t i = 0; i < dsg.getAllocatedDataSize(s); ++i) {
+          BOOST_CHECK_EQUAL(readDSG.getData(s)[i], isRead ? dsg.getData(s)[i] : 0.);
+        }
+      }
+    };
+    const auto secondLevelSum = std::next(blocks.begin())->first;
+    numRead =
+        DistributedSparseGridIO::readProgressiveFile(readDSG, "test_sg_progressive", secondLevelSum);
+    BOOST_CHECK_EQUAL(numRead, 2);
+    checkPrefix(secondLevelSum);
+
+    // with a budget, the writer stops after the last complete level sum that fits
+    size_t totalNumPoints = dsg.getRawDataSize();
+    MPI_Allreduce(MPI_IN_PLACE, &totalNumPoints, 1,
+                  getMPIDatatype(abstraction::getabstractionDataType<size_t>()), MPI_SUM, comm);
+    numWritten = DistributedSparseGridIO::writeProgressiveFile(
+        dsg, "test_sg_progressive", totalNumPoints * sizeof(combigrid::real) / 2);
+    BOOST_CHECK_GT(numWritten, 0);
+    BOOST_CHECK_LT(numWritten, blocks.size());
+    numRead = DistributedSparseGridIO::readProgressiveFile(readDSG, "test_sg_progressive");
+    BOOST_CHECK_EQUAL(numRead, numWritten);
+    checkPrefix(std::next(blocks.begin(), numWritten - 1)->first);
+    MPI_Barrier(comm);
+    if (rank == 0) {
+      BOOST_CHECK_LE(std::ifstream("test_sg_progressive", std::ios::ate).tellg(),
+                     totalNumPoints * sizeof(combigrid::real) / 2);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_anyDistributedSparseGrid) {
   int nprocs = 9;
   CommunicatorType comm = TestHelper::getComm(nprocs);
@@ -1091,4 +1443,137 @@ BOOST_AUTO_TEST_CASE(test_sparseGridAndSubspaceReduce) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(test_reproducibleReduce) {
+  int nprocs = 9;
+  CommunicatorType fullComm = TestHelper::getComm(nprocs);
+  if (fullComm != MPI_COMM_NULL) {
+    theMPISystem()->initWorldReusable(fullComm, nprocs, 1, false, true);
+    const auto rank = TestHelper::getRank(fullComm);
+    MPI_Datatype fixedPointType = CombiCom::getFixedPointDatatype();
+    MPI_Op fixedPointAdd;
+    MPI_Op_create(CombiCom::addFixedPointValues, true, &fixedPointAdd);
+
+    // summands of very different magnitudes, which MPI_SUM would add order-dependently
+    const int count = 1000;
+    auto getSummands = [&](int summandRank) {
+      std::vector<real> summands(count);
+      std::mt19937 generator(summandRank);
+      std::uniform_real_distribution<real> distribution(-1., 1.);
+      for (int i = 0; i < count; ++i) {
+        summands[i] = distribution(generator) * std::pow(10., (i + summandRank) % 40 - 20);
+      }
+      return summands;
+    };
+    auto sum = getSummands(rank);
+    CombiCom::reproducibleReduce(sum.data(), static_cast<real*>(nullptr), count, MPI_PROC_NULL,
+                                 fullComm, fixedPointAdd, fixedPointType);
+    // the result is close to the exact sum
+    std::vector<long double> exactSum(count, 0.);
+    for (int r = 0; r < nprocs; ++r) {
+      auto summands = getSummands(r);
+      for (int i = 0; i < count; ++i) exactSum[i] += summands[i];
+    }
+    for (int i = 0; i < count; ++i) {
+      BOOST_CHECK_LE(std::abs(sum[i] - static_cast<real>(exactSum[i])),
+                     2. * std::numeric_limits<real>::epsilon() * std::abs(sum[i]));
+    }
+
+    // reversed process order, permuted summands, and reduce to one rank: bitwise identical
+    MPI_Comm reversedComm;
+    MPI_Comm_split(fullComm, 0, nprocs - rank, &reversedComm);
+    auto reversedSum = getSummands((rank + 4) % nprocs);
+    CombiCom::reproducibleReduce(reversedSum.data(), static_cast<real*>(nullptr), count,
+                                 MPI_PROC_NULL, reversedComm, fixedPointAdd, fixedPointType);
+    BOOST_CHECK(std::memcmp(sum.data(), reversedSum.data(), count * sizeof(real)) == 0);
+    auto reducedSum = getSummands(rank);
+    CombiCom::reproducibleReduce(reducedSum.data(), static_cast<real*>(nullptr), count, 3,
+                                 reversedComm, fixedPointAdd, fixedPointType);
+    if (TestHelper::getRank(reversedComm) == 3) {
+      BOOST_CHECK(std::memcmp(sum.data(), reducedSum.data(), count * sizeof(real)) == 0);
+    }
+    MPI_Comm_free(&reversedComm);
+
+    // cancellation is exact, Kahan terms are subtracted, and complex numbers are summed per part
+    std::vector<std::complex<real>> values(3, 0.);
+    std::vector<std::complex<real>> kahanTerms(3, 0.);
+    if (rank == 0) values[0] = {1e20, -1.};
+    if (rank == 1) values[0] = {1., 1e-15};
+    if (rank == 2) values[0] = {-1e20, 1.};
+    values[1] = {1., 0.5};
+    kahanTerms[1] = {0.5, 1.};
+    values[2] = std::numeric_limits<real>::infinity();
+    CombiCom::reproducibleReduce(values.data(), kahanTerms.data(), 3, MPI_PROC_NULL, fullComm,
+                                 fixedPointAdd, fixedPointType);
+    BOOST_CHECK_EQUAL(values[0].real(), 1.);
+    BOOST_CHECK_EQUAL(values[0].imag(), 1e-15);
+    BOOST_CHECK_EQUAL(values[1].real(), 0.5 * nprocs);
+    BOOST_CHECK_EQUAL(values[1].imag(), -0.5 * nprocs);
+    BOOST_CHECK(std::isnan(values[2].real()));
+    BOOST_CHECK_EQUAL(values[2].imag(), 0.);
+    for (const auto& k : kahanTerms) BOOST_CHECK_EQUAL(k, std::complex<real>(0.));
+    MPI_Op_free(&fixedPointAdd);
+    MPI_Type_free(&fixedPointType);
+
+    // the sparse grid and subspace reduce give the same bits, independent of the chunk size
+    const DimType dim = 3;
+    const LevelVector lmin(dim, 2), lmax(dim, 9);
+    auto myOwnComm = TestHelper::getCommSelfAsCartesian(dim);
+    DistributedSparseGridUniform<real> uniDSG(dim, lmax, lmin, myOwnComm);
+    CombiMinMaxScheme combischeme(dim, lmin, lmax);
+    combischeme.createAdaptiveCombischeme();
+    for (const auto& level : combischeme.getCombiSpaces()) {
+      DistributedFullGrid<real> dfg(dim, level, myOwnComm, std::vector<BoundaryType>(dim, 1),
+                                    nullptr, std::vector<int>(dim, 1), false);
+      uniDSG.registerDistributedFullGrid(dfg);
+    }
+    uniDSG.setSubspaceCommunicators(fullComm, rank);
+    uniDSG.createSubspaceData();
+    auto setValues = [&]() {
+      for (size_t i = 0; i < uniDSG.getRawDataSize(); ++i) {
+        uniDSG.getRawData()[i] = std::sin(static_cast<real>(i + 1) * (rank + 1)) / (rank + 3);
+      }
+    };
+    setValues();
+    CombiCom::distributedGlobalSparseGridReduce(uniDSG, 0, MPI_PROC_NULL, fullComm, true);
+    std::vector<real> sparseGridReduced(uniDSG.getRawData(),
+                                        uniDSG.getRawData() + uniDSG.getRawDataSize());
+    for (uint32_t chunkSizePerThreadInMiB : {1, 64}) {
+      setValues();
+      CombiCom::distributedGlobalSubspaceReduce(uniDSG, chunkSizePerThreadInMiB, MPI_PROC_NULL,
+                                                true);
+      BOOST_CHECK(std::memcmp(sparseGridReduced.data(), uniDSG.getRawData(),
+                              uniDSG.getRawDataSize() * sizeof(real)) == 0);
+    }
+    BOOST_CHECK(!TestHelper::testStrayMessages(fullComm));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_sparseGridEvaluation) {
+  for (BoundaryType bValue : std::vector<BoundaryType>({0, 1, 2})) {
+    for (std::vector<int> procs : std::vector<std::vector<int>>({{1, 1, 1}, {2, 2, 2}})) {
+      std::vector<BoundaryType> boundary(3, bValue);
+      BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(8));
+      checkSparseGridEvaluation({4, 3, 5}, procs, boundary, LevelVector(3, 0));
+      if (bValue > 0) {
+        checkSparseGridEvaluation({4, 3, 5}, procs, boundary, {2, 1, 2});
+      }
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_sparseGridFileComparison) {
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(8));
+  for (BoundaryType bValue : std::vector<BoundaryType>({0, 1, 2})) {
+    for (std::vector<int> procs : std::vector<std::vector<int>>({{1, 1, 1}, {2, 2, 2}})) {
+      std::vector<BoundaryType> boundary(3, bValue);
+      checkSparseGridFileComparison({4, 3, 5}, procs, boundary, LevelVector(3, 0));
+      if (bValue > 0) {
+        checkSparseGridFileComparison({4, 3, 5}, procs, boundary, {2, 1, 2});
+      }
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
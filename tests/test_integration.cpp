@@ -149,6 +149,13 @@ void checkIntegration(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundar
     // computations start
     BOOST_TEST_CHECKPOINT("manager update combi parameters");
     manager.updateCombiParameters();
+#ifdef DISCOTEC_USE_HIGHFIVE
+    if (!pretendThirdLevel) {
+      // a 1D marginal of the combined solution, written after every combination
+      manager.addInSituProjection(SparseGridProjection::marginal(
+          "integration_" + std::to_string(boundaryV) + "_marginal", dim, {0}, LevelVector(dim, 3)));
+    }
+#endif  // def DISCOTEC_USE_HIGHFIVE
 
     /* distribute task according to load model and start computation for
      * the first time */
@@ -186,9 +193,16 @@ void checkIntegration(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundar
 
     Stats::startEvent("manager get norms");
     // get all kinds of norms
-    manager.getLpNorms(0);
-    manager.getLpNorms(1);
-    manager.getLpNorms(2);
+    auto maxNorms = manager.getLpNorms(0);
+    auto oneNorms = manager.getLpNorms(1);
+    auto twoNorms = manager.getLpNorms(2);
+    auto allNorms = manager.getAllLpNorms();
+    BOOST_CHECK_EQUAL(allNorms.size(), maxNorms.size());
+    for (const auto& [taskID, norms] : allNorms) {
+      BOOST_CHECK_EQUAL(norms[0], maxNorms[taskID]);
+      BOOST_CHECK_CLOSE(norms[1], oneNorms[taskID], TestHelper::tolerance);
+      BOOST_CHECK_CLOSE(norms[2], twoNorms[taskID], TestHelper::tolerance);
+    }
     Stats::stopEvent("manager get norms");
 
     BOOST_TEST_CHECKPOINT("write solution");
@@ -222,6 +236,17 @@ void checkIntegration(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundar
       BOOST_TEST_MESSAGE("manager interpolate: " << Stats::getDuration("manager interpolate")
                                                  << " milliseconds");
 
+      // the combined sparse grid has to give the same values as the component grids
+      BOOST_TEST_CHECKPOINT("MC interpolation on sparse grid");
+      auto sparseGridValues = manager.interpolateValuesOnSparseGrid(interpolationCoords);
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        BOOST_CHECK_SMALL(std::abs(sparseGridValues[i] - values[i]), TestHelper::tolerance);
+      }
+      BOOST_TEST_CHECKPOINT("write downsampled sparse grid");
+      manager.writeSparseGridSliceXdmf(
+          std::vector<real>(dim, std::numeric_limits<real>::quiet_NaN()), LevelVector(dim, 3),
+          "integration_" + std::to_string(boundaryV) + "_downsampled");
+
       if (boundaryV > 1) {
         TestFnCount<CombiDataType> initialFunction;
         for (size_t i = 0; i < interpolationCoords.size(); ++i) {
@@ -2,9 +2,14 @@
 #include <boost/test/unit_test.hpp>
 
 #include <chrono>
+#include <fstream>
+#include <sstream>
 #include <thread>
 
+#include "hierarchization/DistributedHierarchization.hpp"
+#include "mpi/CommunicationCounters.hpp"
 #include "utils/Stats.hpp"
+#include "utils/Tracing.hpp"
 #include "mpi/MPISystem.hpp"
 #include "utils/Types.hpp"
 #include "test_helper.hpp"
@@ -73,6 +78,153 @@ void testMeasureTime(int size, long for_milliseconds) {
 
   combigrid::Stats::finalize();
 }
+void checkTracing(int size) {
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(size));
+
+  combigrid::CommunicatorType comm = TestHelper::getComm(size);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+
+  // record nested events, the inner one with a communicated volume
+  const auto outerID = combigrid::Tracing::registerEvent("outer");
+  const auto innerID = combigrid::Tracing::registerEvent("inner \"quoted\"");
+  BOOST_CHECK_EQUAL(outerID, combigrid::Tracing::registerEvent("outer"));
+  BOOST_CHECK_EQUAL(combigrid::Tracing::getEventName(outerID), "outer");
+
+  combigrid::Tracing::initialize();
+  const int numInner = 10;
+  {
+    combigrid::Tracing::Scope outer(outerID);
+    for (int i = 0; i < numInner; ++i) {
+      combigrid::Tracing::Scope inner(innerID);
+      inner.addBytes(8);
+    }
+  }
+  combigrid::Tracing::finalize();
+  // records after finalize are ignored
+  combigrid::Tracing::begin(outerID);
+#ifdef TIMING
+  BOOST_CHECK_EQUAL(combigrid::Tracing::getNumberOfRecords(), 2 * (numInner + 1));
+  BOOST_CHECK_EQUAL(combigrid::Tracing::getNumberOfDroppedRecords(), 0);
+#endif  // def TIMING
+  combigrid::Tracing::writeChromeTrace("test_tracing_output.json", comm);
+  combigrid::Tracing::writeBinary("test_tracing_output.bin", comm);
+
+#ifdef TIMING
+  if (TestHelper::getRank(comm) == 0) {
+    std::ifstream jsonFile("test_tracing_output.json");
+    std::stringstream contents;
+    contents << jsonFile.rdbuf();
+    const std::string json = contents.str();
+    BOOST_CHECK_EQUAL(json.find("{\"displayTimeUnit\""), 0);
+    BOOST_CHECK(json.find("\"args\":{\"bytes\":8}") != std::string::npos);
+    BOOST_CHECK(json.find("inner \\\"quoted\\\"") != std::string::npos);
+    BOOST_CHECK_EQUAL(json.substr(json.size() - 3), "]}\n");
+
+    std::ifstream binaryFile("test_tracing_output.bin", std::ios::binary);
+    char magic[8];
+    binaryFile.read(magic, sizeof(magic));
+    BOOST_CHECK_EQUAL(std::string(magic, sizeof(magic)), "DCTTRACE");
+  }
+
+  // small ring buffers overwrite the oldest records
+  combigrid::Tracing::initialize(4);
+  for (int i = 0; i < numInner; ++i) {
+    combigrid::Tracing::Scope inner(innerID);
+  }
+  combigrid::Tracing::finalize();
+  BOOST_CHECK_EQUAL(combigrid::Tracing::getNumberOfRecords(), 4);
+  BOOST_CHECK_EQUAL(combigrid::Tracing::getNumberOfDroppedRecords(), 2 * numInner - 4);
+#endif  // def TIMING
+}
+
+void checkCommunicationCounters() {
+  using combigrid::CommunicationCounters;
+  using combigrid::CommunicationPhase;
+  using combigrid::CommunicatorKind;
+  std::vector<int> procs = {2, 2};
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(4));
+  combigrid::CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  CommunicationCounters::reset();
+
+  // explicit records are attributed to phase and communicator
+  CommunicationCounters::record(CommunicationPhase::globalReduce, CommunicatorKind::globalReduce,
+                                2, 1024, 0.5);
+  CommunicationCounters::record(CommunicationPhase::globalReduce, CommunicatorKind::globalReduce,
+                                1, 1024, 0.5);
+  auto reduceCounter = CommunicationCounters::getStepCounter(CommunicationPhase::globalReduce,
+                                                             CommunicatorKind::globalReduce);
+  BOOST_CHECK_EQUAL(reduceCounter.numMessages, 3);
+  BOOST_CHECK_EQUAL(reduceCounter.bytes, 2048);
+  BOOST_CHECK_CLOSE(reduceCounter.waitSeconds, 1., 1e-6);
+  BOOST_CHECK_EQUAL(CommunicationCounters::getStepSummary(),
+                    "global reduce/globalReduce: 3 msgs 2048 B 1 s 0.001953 MiB/s");
+
+  // the phase scopes nest
+  BOOST_CHECK(CommunicationCounters::getCurrentPhase() == CommunicationPhase::unattributed);
+  {
+    CommunicationCounters::PhaseScope outer(CommunicationPhase::broadcast);
+    {
+      CommunicationCounters::PhaseScope inner(CommunicationPhase::thirdLevel);
+      BOOST_CHECK(CommunicationCounters::getCurrentPhase() == CommunicationPhase::thirdLevel);
+    }
+    BOOST_CHECK(CommunicationCounters::getCurrentPhase() == CommunicationPhase::broadcast);
+  }
+  BOOST_CHECK(CommunicationCounters::getCurrentPhase() == CommunicationPhase::unattributed);
+
+  // the test communicator is none of the MPISystem's
+  BOOST_CHECK(CommunicationCounters::getCommunicatorKind(comm) == CommunicatorKind::other);
+
+  // the hierarchization reports its halo exchange
+  combigrid::LevelVector levels = {3, 3};
+  std::vector<combigrid::BoundaryType> boundary(2, 2);
+  combigrid::OwningDistributedFullGrid<double> dfg(2, levels, comm, boundary, procs);
+  combigrid::DistributedHierarchization::hierarchize<double>(dfg);
+  auto hierarchizationCounter = CommunicationCounters::getStepCounter(
+      CommunicationPhase::hierarchization, CommunicatorKind::other);
+  if (combigrid::usePMPICounters || combigrid::countCommunicationExplicitly) {
+    BOOST_CHECK_GT(hierarchizationCounter.numMessages, 0);
+    BOOST_CHECK_GT(hierarchizationCounter.bytes, 0);
+    BOOST_CHECK_EQUAL(hierarchizationCounter.bytes % sizeof(double), 0);
+  } else {
+    BOOST_CHECK_EQUAL(hierarchizationCounter.numMessages, 0);
+  }
+
+  // finishing the step moves the counters to the totals and publishes them as attributes
+  combigrid::Stats::initialize();
+  CommunicationCounters::finishStep(0);
+  BOOST_CHECK_EQUAL(CommunicationCounters::getStepCounter(CommunicationPhase::globalReduce,
+                                                          CommunicatorKind::globalReduce)
+                        .numMessages,
+                    0);
+  BOOST_CHECK_EQUAL(CommunicationCounters::getStepSummary(), "");
+  BOOST_CHECK_EQUAL(CommunicationCounters::getTotalCounter(CommunicationPhase::globalReduce,
+                                                           CommunicatorKind::globalReduce)
+                        .bytes,
+                    2048);
+  CommunicationCounters::writeTotalsToStats();
+  combigrid::Stats::finalize();
+  combigrid::Stats::write("test_communication_counters_output", comm);
+#ifdef TIMING
+  if (TestHelper::getRank(comm) == 0) {
+    std::ifstream statsFile("test_communication_counters_output");
+    std::stringstream contents;
+    contents << statsFile.rdbuf();
+    const std::string json = contents.str();
+    BOOST_CHECK(json.find("\"communication step 0\":\"hierarchization/other: ") !=
+                std::string::npos);
+    BOOST_CHECK(json.find("global reduce/globalReduce: 3 msgs 2048 B 1 s") != std::string::npos);
+    BOOST_CHECK(json.find("\"communication global reduce globalReduce\":\"3 2048 1.0") !=
+                std::string::npos);
+  }
+#endif  // def TIMING
+  CommunicationCounters::reset();
+}
+
 BOOST_FIXTURE_TEST_SUITE(stats, TestHelper::BarrierAtEnd, *boost::unit_test::timeout(60))
 
 BOOST_AUTO_TEST_CASE(test_3, * boost::unit_test::timeout(20)) {
@@ -83,6 +235,15 @@ BOOST_AUTO_TEST_CASE(test_1, * boost::unit_test::timeout(20)) {
     checkStats(9);
 }
 
+BOOST_AUTO_TEST_CASE(test_tracing, *boost::unit_test::timeout(20)) {
+  checkTracing(1);
+  checkTracing(9);
+}
+
+BOOST_AUTO_TEST_CASE(test_communication_counters, *boost::unit_test::timeout(20)) {
+  checkCommunicationCounters();
+}
+
 BOOST_AUTO_TEST_CASE(test_time) {
   testMeasureTime(9,1);
   testMeasureTime(9,10);
@@ -14,6 +14,7 @@
 #include "loadmodel/LearningLoadModel.hpp"
 #include "loadmodel/LinearLoadModel.hpp"
 #include "manager/CombiParameters.hpp"
+#include "manager/InterpolationWorker.hpp"
 #include "manager/ProcessGroupWorker.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
 #include "stdlib.h"
@@ -175,6 +176,7 @@ void checkWorkerOnly(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundary
   worker.getLpNorms(0);
   worker.getLpNorms(1);
   worker.getLpNorms(2);
+  worker.getAllLpNorms();
   Stats::stopEvent("worker get norms");
 
   BOOST_TEST_CHECKPOINT("write solution");
@@ -257,6 +259,22 @@ void checkWorkerOnly(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundary
         BOOST_CHECK_CLOSE(std::real(ref), std::real(values[i]), TestHelper::tolerance);
       }
     }
+    // the same values if only the output master needs them, and the same as a dense reduction
+    auto outputMasterValues = worker.interpolateValues(interpolationCoords, true);
+    auto denseValues =
+        combigrid::interpolateValues<CombiDataType>(worker.getTasks(), interpolationCoords);
+    bool isOutputMaster = false;
+    OTHER_OUTPUT_GROUP_EXCLUSIVE_SECTION {
+      MASTER_EXCLUSIVE_SECTION { isOutputMaster = true; }
+    }
+    BOOST_CHECK_EQUAL(outputMasterValues.size(), isOutputMaster ? values.size() : 0);
+    for (size_t i = 0; i < outputMasterValues.size(); ++i) {
+      BOOST_CHECK_SMALL(std::abs(outputMasterValues[i] - values[i]), TestHelper::tolerance);
+    }
+    BOOST_REQUIRE_EQUAL(denseValues.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      BOOST_CHECK_SMALL(std::abs(denseValues[i] - values[i]), TestHelper::tolerance);
+    }
     // output files are not needed, remove previous ones
     // (if this doesn't happen, there may be hdf5 errors due to duplicates)
     OUTPUT_GROUP_EXCLUSIVE_SECTION {
@@ -305,6 +323,75 @@ void checkWorkerOnly(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundary
   BOOST_CHECK(!TestHelper::testStrayMessages(comm));
 }
 
+void checkTuneCombination(size_t ngroup, size_t nprocs) {
+  size_t size = ngroup * nprocs;
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(size));
+  CommunicatorType comm = TestHelper::getComm(size);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  combigrid::Stats::initialize();
+  theMPISystem()->initWorldReusable(comm, ngroup, nprocs, false);
+
+  DimType dim = 2;
+  LevelVector lmin(dim, 2);
+  LevelVector lmax(dim, 5);
+  std::vector<BoundaryType> boundary(dim, 2);
+  CombiMinMaxScheme combischeme(dim, lmin, lmax);
+  combischeme.createAdaptiveCombischeme();
+  std::vector<size_t> myTaskIDs;
+  std::vector<LevelVector> myLevels;
+  std::vector<real> myCoeffs;
+  combigrid::getRoundRobinLevels(combischeme, theMPISystem()->getProcessGroupNumber(), ngroup,
+                                 myLevels, myCoeffs, myTaskIDs);
+  auto loadmodel = std::unique_ptr<LoadModel>(new LinearLoadModel());
+  const std::string tuningFile = "worker_only_tuning.txt";
+  const std::vector<uint32_t> chunkSizes = {1, 16};
+
+  std::pair<CombinationVariant, uint32_t> firstChoice;
+  for (bool fromFile : {false, true}) {
+    ProcessGroupWorker worker;
+    CombiParameters params(dim, lmin, lmax, boundary, 2, 1, CombinationVariant::sparseGridReduce,
+                           {static_cast<int>(nprocs), 1}, LevelVector(0), LevelVector(0), 64,
+                           false);
+    worker.setCombiParameters(std::move(params));
+    worker.initializeAllTasks<TaskCount>(myLevels, myCoeffs, myTaskIDs, loadmodel.get());
+
+    auto choice = worker.tuneCombination(
+        tuningFile, 0,
+        {CombinationVariant::sparseGridReduce, CombinationVariant::outgroupSparseGridReduce,
+         CombinationVariant::chunkedOutgroupSparseGridReduce},
+        chunkSizes);
+    MPI_Barrier(comm);
+    BOOST_CHECK(std::filesystem::exists(tuningFile));
+    BOOST_CHECK(std::find(chunkSizes.begin(), chunkSizes.end(), choice.second) !=
+                chunkSizes.end());
+    BOOST_CHECK(worker.getCombiParameters().getCombinationVariant() == choice.first);
+    BOOST_CHECK_EQUAL(worker.getCombiParameters().getChunkSizeInMebibybtePerThread(),
+                      choice.second);
+    if (fromFile) {
+      // the second worker reads the choice instead of tuning
+      BOOST_CHECK(choice == firstChoice);
+    }
+    firstChoice = choice;
+
+    // the tasks' values are as before tuning, so the combination gives the expected result
+    worker.initCombinedDSGVector();
+    worker.zeroDsgsData();
+    worker.runAllTasks();
+    worker.combineAtOnce();
+    BOOST_CHECK(checkReducedFullGridIntegration(worker, 1));
+    worker.exit();
+  }
+  MPI_Barrier(comm);
+  if (getCommRank(comm) == 0) {
+    remove(tuningFile.c_str());
+  }
+  combigrid::Stats::finalize();
+  MPI_Barrier(comm);
+  BOOST_CHECK(!TestHelper::testStrayMessages(comm));
+}
+
 #ifndef ISGENE  // worker tests won't work with ISGENE because of worker magic
 
 #ifndef NDEBUG  // in case of a build with asserts, have longer timeout
@@ -373,5 +460,14 @@ BOOST_AUTO_TEST_CASE(test_1, *boost::unit_test::tolerance(TestHelper::higherTole
   BOOST_TEST_MESSAGE("time to run all 'worker' tests: " << duration.count() << " milliseconds");
 }
 
+BOOST_AUTO_TEST_CASE(test_tune_combination) {
+  for (size_t ngroup : {1, 2, 4}) {
+    for (size_t nprocs : {1, 2}) {
+      BOOST_CHECK_NO_THROW(checkTuneCombination(ngroup, nprocs));
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
@@ -0,0 +1,156 @@
+// to resolve https://github.com/open-mpi/ompi/issues/5157
+#define OMPI_SKIP_MPICXX 1
+#include <mpi.h>
+
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "combicom/CombiCom.hpp"
+#include "combischeme/CombiMinMaxScheme.hpp"
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "sparsegrid/DistributedSparseGridIO.hpp"
+#include "sparsegrid/SparseGridFileComparison.hpp"
+#include "utils/MonteCarlo.hpp"
+#include "utils/Stats.hpp"
+
+using namespace combigrid;
+
+int main(int argc, char** argv) {
+  [[maybe_unused]] auto mpiOnOff = MpiOnOff(&argc, &argv);
+  combigrid::Stats::initialize();
+
+  // read in parameter file -- use the same one as for the simulation, and add an [error] section
+  // (and adapt p/nprocs if you are using fewer processes than in your target scenario)
+  std::string paramfile = "ctparam";
+  if (argc > 1) paramfile = argv[1];
+  boost::property_tree::ptree cfg;
+  boost::property_tree::ini_parser::read_ini(paramfile, cfg);
+
+  // only need one process group here
+  size_t ngroup = 1;
+  size_t nprocs = cfg.get<size_t>("manager.nprocs");
+
+  theMPISystem()->initWorldReusable(MPI_COMM_WORLD, ngroup, nprocs, false);
+
+  /* read other parameters from ctparam */
+  DimType dim = cfg.get<DimType>("ct.dim");
+  LevelVector lmin(dim), lmax(dim);
+  std::vector<int> p(dim);
+  cfg.get<std::string>("ct.lmin") >> lmin;
+  cfg.get<std::string>("ct.lmax") >> lmax;
+  cfg.get<std::string>("ct.p") >> p;
+  std::vector<BoundaryType> boundary(dim, cfg.get<BoundaryType>("ct.boundary", 1));
+  auto forwardDecomposition = cfg.get<bool>("ct.forwardDecomposition", false);
+
+  std::string fileName = cfg.get<std::string>("error.file");
+  std::string otherFileName = cfg.get<std::string>("error.otherfile");
+  // if given, the subspace sizes are read from this file instead of registering the ct scheme
+  std::string subspaceSizesFile = cfg.get<std::string>("error.subspacesizes", "");
+  auto reduceLmaxBy = cfg.get<LevelType>("error.reducelmax", 1);
+  auto chunkSizeInMebibyte = cfg.get<uint32_t>("error.chunksize", 64);
+  auto numMonteCarloPoints = cfg.get<int>("error.numMCpoints", 0);
+  // optional component grid file written by DistributedFullGrid::writePlotFile, compared to both
+  // sparse grid files at the Monte-Carlo points
+  std::string referenceGridFile = cfg.get<std::string>("error.referencegrid", "");
+  std::string outputPrefix = cfg.get<std::string>("error.output", "sparse_grid_error");
+
+  // check whether parallelization vector p agrees with nprocs
+  int checkProcs = 1;
+  for (auto k : p) checkProcs *= k;
+  if (checkProcs != IndexType(nprocs)) {
+    throw std::invalid_argument("process group size and parallelization do not match");
+  }
+  IndexVector maxNumPoints(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    maxNumPoints[d] = combigrid::getNumDofNodal(lmax[d], boundary[d]);
+  }
+  auto decomposition = combigrid::getDefaultDecomposition(maxNumPoints, p, forwardDecomposition);
+
+  // make local communicator cartesian
+  std::vector<int> periods(dim);
+  int reorder = false;
+  MPI_Comm new_communicator;
+  MPI_Cart_create(theMPISystem()->getLocalComm(), dim, p.data(), periods.data(), reorder,
+                  &new_communicator);
+  theMPISystem()->storeLocalComm(new_communicator);
+
+  // the sparse grid that was written, without data
+  LevelVector reducedLmax = lmax;
+  for (DimType d = 0; d < dim; ++d) {
+    reducedLmax[d] = std::max(lmin[d], static_cast<LevelType>(lmax[d] - reduceLmaxBy));
+  }
+  DistributedSparseGridUniform<CombiDataType> uniDSG(dim, reducedLmax, lmin,
+                                                     theMPISystem()->getLocalComm());
+  if (subspaceSizesFile.empty()) {
+    std::string ctschemeFile = cfg.get<std::string>("ct.ctscheme");
+    std::unique_ptr<CombiMinMaxSchemeFromFile> scheme(
+        new CombiMinMaxSchemeFromFile(dim, lmin, lmax, ctschemeFile));
+    for (const auto& l : scheme->getCombiSpaces()) {
+      auto dfgDecomposition = combigrid::downsampleDecomposition(decomposition, lmax, l, boundary);
+      DistributedFullGrid<CombiDataType> uniDFG(dim, l, theMPISystem()->getLocalComm(), boundary,
+                                                nullptr, p, forwardDecomposition, dfgDecomposition);
+      uniDSG.registerDistributedFullGrid(uniDFG);
+    }
+  } else {
+    DistributedSparseGridIO::readSubspaceSizesFromFile(uniDSG, subspaceSizesFile);
+  }
+
+  // the reference grid only describes the domain decomposition
+  DistributedFullGrid<CombiDataType> referenceGrid(dim, lmax, theMPISystem()->getLocalComm(),
+                                                   boundary, nullptr, p, forwardDecomposition,
+                                                   decomposition);
+  SparseGridFileComparison<CombiDataType> comparison(uniDSG, referenceGrid, lmin);
+  std::vector<std::vector<real>> interpolationCoords;
+  if (numMonteCarloPoints > 0) {
+    // the same pseudo-random points on every process
+    interpolationCoords = montecarlo::getRandomCoordinates(numMonteCarloPoints, dim);
+  }
+  Stats::startEvent("compare sparse grid files");
+  comparison.compare(fileName, otherFileName,
+                     CombiCom::getGlobalReduceChunkSize<CombiDataType>(chunkSizeInMebibyte),
+                     interpolationCoords);
+  Stats::stopEvent("compare sparse grid files");
+
+  MASTER_EXCLUSIVE_SECTION {
+    comparison.writeSubspaceDifferences(outputPrefix + "_subspaces.txt");
+    auto bounds = comparison.getErrorBounds();
+    std::cout << "error bounds from surplus differences: max " << bounds[0] << ", L1 "
+              << bounds[1] << ", L2 " << bounds[2] << std::endl;
+    if (numMonteCarloPoints > 0) {
+      auto errors = SparseGridFileComparison<CombiDataType>::getPointwiseErrors(
+          comparison.getInterpolatedValues(0), comparison.getInterpolatedValues(1));
+      std::cout << "errors at " << numMonteCarloPoints << " Monte-Carlo points: max " << errors[0]
+                << ", mean " << errors[1] << ", RMS " << errors[2] << std::endl;
+    }
+  }
+
+  if (!referenceGridFile.empty() && numMonteCarloPoints > 0) {
+    LevelVector referenceLevel = lmax;
+    auto referenceLevelString = cfg.get<std::string>("error.referencelevel", "");
+    if (!referenceLevelString.empty()) referenceLevelString >> referenceLevel;
+    auto referenceDecomposition =
+        combigrid::downsampleDecomposition(decomposition, lmax, referenceLevel, boundary);
+    OwningDistributedFullGrid<CombiDataType> componentGrid(
+        dim, referenceLevel, theMPISystem()->getLocalComm(), boundary, p, forwardDecomposition,
+        referenceDecomposition);
+    componentGrid.readPlotFile(referenceGridFile.c_str());
+    auto referenceValues = componentGrid.getInterpolatedValues(interpolationCoords);
+    MASTER_EXCLUSIVE_SECTION {
+      for (size_t f = 0; f < 2; ++f) {
+        auto errors = SparseGridFileComparison<CombiDataType>::getPointwiseErrors(
+            comparison.getInterpolatedValues(f), referenceValues);
+        std::cout << "errors of " << (f == 0 ? fileName : otherFileName)
+                  << " w.r.t. the reference grid: max " << errors[0] << ", mean " << errors[1]
+                  << ", RMS " << errors[2] << std::endl;
+      }
+    }
+  }
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  combigrid::Stats::finalize();
+  return 0;
+}